@@ -0,0 +1,103 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal benchmark harness for `ege_bench`.
+//
+// A benchmark is a function taking a `State&` and looping over it:
+//
+//   EGE_BENCHMARK(queue_push_pop, 1000000) {
+//       for (auto _ : state) { ... }
+//   }
+//
+// The timer runs for the duration of the range-for loop; setup done before
+// the loop is not measured. Benchmarks can attach named counters that are
+// reported next to the timing.
+namespace ege::bench {
+
+class State {
+public:
+    explicit State(std::size_t iterations) noexcept : iterations_(iterations) {}
+
+    // Non-trivial so `for (auto _ : state)` does not trip unused-variable warnings.
+    struct Tick { ~Tick() {} };
+
+    struct Iterator {
+        State* state;
+        std::size_t remaining;
+        Tick operator*() const noexcept { return Tick{}; }
+        Iterator& operator++() noexcept { --remaining; return *this; }
+        bool operator!=(const Iterator&) const noexcept {
+            if (remaining != 0) return true;
+            state->stop_timer();
+            return false;
+        }
+    };
+
+    Iterator begin() noexcept { start_timer(); return Iterator{this, iterations_}; }
+    Iterator end() noexcept { return Iterator{this, 0}; }
+
+    [[nodiscard]] std::size_t iterations() const noexcept { return iterations_; }
+    [[nodiscard]] double elapsed_ns() const noexcept { return elapsed_ns_; }
+
+    // Exclude a section of the loop body from the measurement.
+    void pause_timing() noexcept { stop_timer(); }
+    void resume_timing() noexcept { start_timer(); }
+
+    // Attach a named value to the result (e.g. items processed, bytes, hit rate).
+    void set_counter(std::string name, double value) {
+        for (auto &c : counters_) {
+            if (c.first == name) { c.second = value; return; }
+        }
+        counters_.emplace_back(std::move(name), value);
+    }
+    [[nodiscard]] const std::vector<std::pair<std::string, double>>& counters() const noexcept { return counters_; }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    void start_timer() noexcept { started_ = clock::now(); running_ = true; }
+    void stop_timer() noexcept {
+        if (!running_) return;
+        elapsed_ns_ += std::chrono::duration<double, std::nano>(clock::now() - started_).count();
+        running_ = false;
+    }
+
+    std::size_t iterations_;
+    clock::time_point started_{};
+    bool running_ = false;
+    double elapsed_ns_ = 0.0;
+    std::vector<std::pair<std::string, double>> counters_;
+};
+
+using BenchmarkFn = std::function<void(State&)>;
+
+// Register a benchmark; returns true so it can initialise a static.
+bool register_benchmark(std::string name, std::size_t iterations, BenchmarkFn fn);
+
+// Prevent the optimiser from discarding a computed value.
+template<typename T>
+inline void do_not_optimize(T const& value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+} // namespace ege::bench
+
+#define EGE_BENCH_CONCAT_INNER(a, b) a##b
+#define EGE_BENCH_CONCAT(a, b) EGE_BENCH_CONCAT_INNER(a, b)
+
+#define EGE_BENCHMARK(name, iterations)                                              \
+    static void name(::ege::bench::State& state);                                    \
+    [[maybe_unused]] static const bool EGE_BENCH_CONCAT(name, _registered) =         \
+        ::ege::bench::register_benchmark(#name, iterations, name);                   \
+    static void name(::ege::bench::State& state)
@@ -0,0 +1,113 @@
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ege::bench {
+
+namespace {
+
+struct Entry {
+    std::string name;
+    std::size_t iterations;
+    BenchmarkFn fn;
+};
+
+std::vector<Entry>& registry() {
+    static std::vector<Entry> entries;
+    return entries;
+}
+
+} // namespace
+
+bool register_benchmark(std::string name, std::size_t iterations, BenchmarkFn fn) {
+    registry().push_back(Entry{std::move(name), iterations, std::move(fn)});
+    return true;
+}
+
+} // namespace ege::bench
+
+namespace {
+
+struct Result {
+    std::string name;
+    std::size_t iterations;
+    double ns_per_op;
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+void print_json_string(const std::string& s) {
+    std::putchar('"');
+    for (const char c : s) {
+        if (c == '"' || c == '\\') std::putchar('\\');
+        std::putchar(c);
+    }
+    std::putchar('"');
+}
+
+void print_json_number(double v) {
+    if (std::isfinite(v)) std::printf("%.17g", v);
+    else std::printf("null");
+}
+
+// One object per run so results can be archived and diffed between
+// releases: {"context": {...}, "benchmarks": [{name, iterations,
+// ns_per_op, counters: {...}}, ...]}.
+void print_json(const std::vector<Result>& results) {
+    std::printf("{\n  \"context\": {\"format_version\": 1, \"compiler\": ");
+#if defined(__VERSION__)
+    print_json_string(__VERSION__);
+#else
+    print_json_string("unknown");
+#endif
+    std::printf(", \"optimized\": %s},\n  \"benchmarks\": [", EGE_BENCH_OPTIMIZED ? "true" : "false");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        std::printf(i ? ",\n    {\"name\": " : "\n    {\"name\": ");
+        print_json_string(r.name);
+        std::printf(", \"iterations\": %zu, \"ns_per_op\": ", r.iterations);
+        print_json_number(r.ns_per_op);
+        std::printf(", \"counters\": {");
+        for (std::size_t c = 0; c < r.counters.size(); ++c) {
+            if (c) std::printf(", ");
+            print_json_string(r.counters[c].first);
+            std::printf(": ");
+            print_json_number(r.counters[c].second);
+        }
+        std::printf("}}");
+    }
+    std::printf("\n  ]\n}\n");
+}
+
+} // namespace
+
+// Usage: ege_bench [--json] [substring-filter]
+// --json prints the results as one JSON document on stdout instead of the
+// human-readable table.
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    bool json = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0) json = true;
+        else filter = argv[i];
+    }
+    std::vector<Result> results;
+    for (auto &e : ege::bench::registry()) {
+        if (filter && e.name.find(filter) == std::string::npos) continue;
+        ege::bench::State state(e.iterations);
+        e.fn(state);
+        const double per_op = state.iterations() ? state.elapsed_ns() / static_cast<double>(state.iterations()) : 0.0;
+        if (json) {
+            results.push_back(Result{e.name, state.iterations(), per_op, state.counters()});
+            continue;
+        }
+        std::printf("%-48s %10zu iters %14.1f ns/op", e.name.c_str(), state.iterations(), per_op);
+        for (const auto &c : state.counters()) std::printf("  %s=%.3f", c.first.c_str(), c.second);
+        std::printf("\n");
+    }
+    if (json) print_json(results);
+    return 0;
+}
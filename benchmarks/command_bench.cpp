@@ -0,0 +1,125 @@
+#include "bench.hpp"
+
+#include <ege/engine/command_buffer.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// Sprite-less UI/tile frame: 16x16 tiles in a few colours over two layers,
+// plus some scattered particles, recorded into a 64 KB buffer.
+constexpr std::size_t kCapacity = 64 * 1024;
+
+std::size_t record_scene(ege::MemoryCommandBuffer<kCapacity> &buf) {
+    std::mt19937 rng(9u);
+    std::uniform_int_distribution<int> pos(0, 319);
+    buf.reset();
+    buf.push_clear(0xFF000000);
+    std::size_t n = 1;
+    for (int16_t y = 0; y < 240; y = static_cast<int16_t>(y + 16)) {
+        for (int16_t x = 0; x < 320; x = static_cast<int16_t>(x + 16), ++n) {
+            buf.push_rect(0, 0xFF000000u | static_cast<uint32_t>((x / 80) * 0x203040), x, y, 16, 16);
+        }
+    }
+    for (int i = 0; i < 400; ++i, ++n) {
+        buf.push_rect(1, 0xFFFFFFFF, static_cast<int16_t>(pos(rng)), static_cast<int16_t>(pos(rng) * 3 / 4), 2, 2);
+    }
+    return n;
+}
+
+void encode_bench(ege::bench::State &state, ege::CommandEncoding encoding) {
+    static ege::MemoryCommandBuffer<kCapacity> buf;
+    buf.set_encoding(encoding);
+    std::size_t n = 0;
+    for (auto _ : state) {
+        n = record_scene(buf);
+        ege::bench::do_not_optimize(buf.view().data());
+    }
+    state.set_counter("commands_per_kb", static_cast<double>(n) * 1024.0 / static_cast<double>(buf.size()));
+    state.set_counter("bytes", static_cast<double>(buf.size()));
+}
+
+void decode_bench(ege::bench::State &state, ege::CommandEncoding encoding) {
+    static ege::MemoryCommandBuffer<kCapacity> buf;
+    buf.set_encoding(encoding);
+    const std::size_t n = record_scene(buf);
+    int64_t sum = 0;
+    for (auto _ : state) {
+        buf.view().for_each([&sum](const ege::RenderCommand &cmd) { sum += cmd.rect.x; sum += cmd.color; });
+        ege::bench::do_not_optimize(sum);
+    }
+    state.set_counter("mcommands_per_s", static_cast<double>(n * state.iterations()) * 1e3 / state.elapsed_ns());
+    state.set_counter("commands_per_kb", static_cast<double>(n) * 1024.0 / static_cast<double>(buf.size()));
+}
+
+EGE_BENCHMARK(command_encode_fixed, 2000) { encode_bench(state, ege::CommandEncoding::Fixed); }
+EGE_BENCHMARK(command_encode_compact, 2000) { encode_bench(state, ege::CommandEncoding::Compact); }
+EGE_BENCHMARK(command_decode_fixed, 5000) { decode_bench(state, ege::CommandEncoding::Fixed); }
+EGE_BENCHMARK(command_decode_compact, 5000) { decode_bench(state, ege::CommandEncoding::Compact); }
+
+} // namespace
+
+namespace {
+
+// 4000 particles recorded as individual rects vs one RectBatch.
+constexpr std::size_t kParticles = 4000;
+
+const std::vector<ege::RectInstance>& particles() {
+    static const std::vector<ege::RectInstance> p = [] {
+        std::mt19937 rng(21u);
+        std::uniform_int_distribution<int> x(0, 317), y(0, 237);
+        std::vector<ege::RectInstance> v(kParticles);
+        for (auto &r : v) r = {static_cast<int16_t>(x(rng)), static_cast<int16_t>(y(rng)), 2, 2};
+        return v;
+    }();
+    return p;
+}
+
+template<bool Batched>
+void record_particles(ege::MemoryCommandBuffer<kCapacity> &buf) {
+    buf.reset();
+    if constexpr (Batched) {
+        buf.push_rect_batch(1, 0xFFFFFFFF, particles());
+    } else {
+        for (const auto &r : particles()) buf.push_rect(1, 0xFFFFFFFF, r.x, r.y, r.w, r.h);
+    }
+}
+
+template<bool Batched>
+void particle_encode_bench(ege::bench::State &state) {
+    static ege::MemoryCommandBuffer<kCapacity> buf;
+    for (auto _ : state) {
+        record_particles<Batched>(buf);
+        ege::bench::do_not_optimize(buf.view().data());
+    }
+    state.set_counter("ns_per_rect", state.elapsed_ns() / static_cast<double>(state.iterations() * kParticles));
+    state.set_counter("bytes", static_cast<double>(buf.size()));
+}
+
+// Walk every rect the way a backend would: one decoded command per rect, or
+// one command whose instance array is read in a loop.
+template<bool Batched>
+void particle_decode_bench(ege::bench::State &state) {
+    static ege::MemoryCommandBuffer<kCapacity> buf;
+    record_particles<Batched>(buf);
+    int64_t sum = 0;
+    for (auto _ : state) {
+        buf.view().for_each([&sum](const ege::RenderCommand &cmd) {
+            if (cmd.type == ege::RenderCommandType::RectBatch) {
+                for (std::size_t i = 0; i < cmd.batch.count; ++i) sum += cmd.rect_instance(i).x;
+            } else {
+                sum += cmd.rect.x;
+            }
+        });
+        ege::bench::do_not_optimize(sum);
+    }
+    state.set_counter("ns_per_rect", state.elapsed_ns() / static_cast<double>(state.iterations() * kParticles));
+}
+
+EGE_BENCHMARK(particles_encode_rects, 1000) { particle_encode_bench<false>(state); }
+EGE_BENCHMARK(particles_encode_batch, 1000) { particle_encode_bench<true>(state); }
+EGE_BENCHMARK(particles_decode_rects, 1000) { particle_decode_bench<false>(state); }
+EGE_BENCHMARK(particles_decode_batch, 1000) { particle_decode_bench<true>(state); }
+
+} // namespace
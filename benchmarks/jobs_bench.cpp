@@ -0,0 +1,53 @@
+#include "bench.hpp"
+
+#include <ege/engine/job_system.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+
+namespace {
+
+// Stand-in for one layer's update: ~50us of arithmetic on private state.
+constexpr std::size_t kLayers = 8;
+
+float layer_update(float seed) noexcept {
+    float x = seed;
+    for (int i = 0; i < 20000; ++i) x = std::sin(x) * 0.5f + 0.25f;
+    return x;
+}
+
+void layers_bench(ege::bench::State &state, ege::JobSystem *jobs) {
+    std::array<float, kLayers> state_of{};
+    for (auto _ : state) {
+        if (jobs == nullptr) {
+            for (std::size_t l = 0; l < kLayers; ++l) state_of[l] = layer_update(state_of[l] + static_cast<float>(l));
+        } else {
+            jobs->parallel_for(kLayers, [&state_of](std::size_t l) {
+                state_of[l] = layer_update(state_of[l] + static_cast<float>(l));
+            });
+        }
+        ege::bench::do_not_optimize(state_of);
+    }
+    state.set_counter("workers", jobs ? static_cast<double>(jobs->worker_count()) : 1.0);
+}
+
+} // namespace
+
+EGE_BENCHMARK(jobs_layer_updates_sequential, 200) { layers_bench(state, nullptr); }
+
+EGE_BENCHMARK(jobs_layer_updates_parallel, 200) {
+    ege::JobSystem jobs;
+    layers_bench(state, &jobs);
+    state.set_counter("steals", static_cast<double>(jobs.steal_count()));
+}
+
+// Scheduling overhead: fan out and join 64 empty jobs.
+EGE_BENCHMARK(jobs_fan_out_join_64, 20000) {
+    ege::JobSystem jobs;
+    for (auto _ : state) {
+        jobs.parallel_for(64, [](std::size_t i) { ege::bench::do_not_optimize(i); });
+    }
+    state.set_counter("ns_per_job", state.elapsed_ns() / static_cast<double>(state.iterations() * 64));
+}
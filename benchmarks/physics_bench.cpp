@@ -0,0 +1,78 @@
+#include "bench.hpp"
+
+#include <ege/physics.hpp>
+#include <ege/engine/job_system.hpp>
+
+#include <random>
+#include <string>
+
+namespace {
+
+using ege::physics::Body;
+using ege::physics::Broadphase;
+
+// Bullet-hell style scene: small bodies spread so density stays constant as
+// the count grows (roughly four bodies per unit-size cell neighbourhood).
+void populate(ege::PhysicsSystem &ps, std::size_t count) {
+    std::mt19937 rng(42u);
+    const float half = std::sqrt(static_cast<float>(count)) * 1.5f;
+    std::uniform_real_distribution<float> pos(-half, half);
+    std::uniform_real_distribution<float> vel(-4.0f, 4.0f);
+    ps.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        Body b;
+        b.pos = {pos(rng), pos(rng)};
+        b.vel = {vel(rng), vel(rng)};
+        if (i % 2 == 0) b.radius = 0.4f; else { b.hx = 0.4f; b.hy = 0.4f; }
+        ps.add_body(b);
+    }
+}
+
+void step_bench(ege::bench::State &state, std::size_t count, Broadphase mode) {
+    ege::PhysicsSystem ps;
+    ps.set_broadphase(mode);
+    populate(ps, count);
+    ps.step(1.0f / 60.0f); // warm buffers
+    for (auto _ : state) {
+        ps.step(1.0f / 60.0f);
+    }
+    ege::bench::do_not_optimize(ps.body(0).pos);
+    state.set_counter("bodies", static_cast<double>(count));
+}
+
+// Crowd scene solved with `step_parallel` on a job system with `workers`
+// threads (0 = one per hardware thread).
+void parallel_step_bench(ege::bench::State &state, std::size_t count, std::size_t workers) {
+    ege::JobSystem jobs(workers);
+    auto parallel_for = [&jobs](std::size_t n, auto &&fn) { jobs.parallel_for(n, fn); };
+    ege::PhysicsSystem ps;
+    populate(ps, count);
+    ps.step_parallel(1.0f / 60.0f, parallel_for);
+    for (auto _ : state) {
+        ps.step_parallel(1.0f / 60.0f, parallel_for);
+    }
+    ege::bench::do_not_optimize(ps.body(0).pos);
+    state.set_counter("bodies", static_cast<double>(count));
+    state.set_counter("workers", static_cast<double>(jobs.worker_count()));
+}
+
+const bool registered = [] {
+    struct Case { std::size_t count; std::size_t iterations; };
+    for (Case c : {Case{100, 2000}, Case{1000, 100}, Case{10000, 3}}) {
+        const std::string n = std::to_string(c.count);
+        ege::bench::register_benchmark("physics_step/brute_force/" + n, c.iterations,
+            [c](ege::bench::State &s) { step_bench(s, c.count, Broadphase::BruteForce); });
+        ege::bench::register_benchmark("physics_step/spatial_hash/" + n, c.iterations * 10,
+            [c](ege::bench::State &s) { step_bench(s, c.count, Broadphase::SpatialHash); });
+    }
+    ege::bench::register_benchmark("physics_step/spatial_hash/50000", 20,
+        [](ege::bench::State &s) { step_bench(s, 50000, Broadphase::SpatialHash); });
+    for (std::size_t workers : {std::size_t{1}, std::size_t{0}}) {
+        const std::string w = workers == 0 ? "all" : std::to_string(workers);
+        ege::bench::register_benchmark("physics_step/parallel_" + w + "/50000", 20,
+            [workers](ege::bench::State &s) { parallel_step_bench(s, 50000, workers); });
+    }
+    return true;
+}();
+
+} // namespace
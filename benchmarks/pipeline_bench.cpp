@@ -0,0 +1,130 @@
+#include "bench.hpp"
+
+#include <ege/engine/render_pipeline.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+void spin_for(std::chrono::microseconds d) {
+    const auto until = clock_type::now() + d;
+    while (clock_type::now() < until) { }
+}
+
+// Input-to-present latency: the producer records a frame every 250us (a fast
+// simulation), the consumer "presents" for 1ms per frame. Latency is measured
+// from the start of recording to the moment the consumer picks the frame up.
+// The SPSC pipeline drains its queue and keeps the newest frame, but its
+// producer has to skip recordings while every buffer is in flight; the
+// mailbox never skips and always hands over the newest completed frame.
+template<typename Pipeline>
+void latency_bench(ege::bench::State &state) {
+    Pipeline pipeline;
+    constexpr std::size_t max_frames = 1u << 20;
+    std::vector<clock_type::time_point> began(max_frames);
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> skipped{0};
+
+    std::thread producer([&] {
+        uint32_t seq = 0;
+        while (!stop.load(std::memory_order_relaxed) && seq + 1 < max_frames) {
+            const auto t = clock_type::now();
+            auto opt = pipeline.begin_frame();
+            if (!opt) {
+                skipped.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                ++seq;
+                began[seq] = t;
+                auto &buf = opt->get();
+                buf.push_clear(seq);
+                for (int i = 0; i < 32; ++i) buf.push_rect(0, seq, 0, 0, 8, 8);
+                pipeline.submit_frame();
+            }
+            spin_for(std::chrono::microseconds(250));
+        }
+    });
+
+    std::vector<double> latencies;
+    latencies.reserve(state.iterations());
+    for (auto _ : state) {
+        uint32_t newest = UINT32_MAX;
+        uint32_t seq = 0;
+        clock_type::time_point picked{};
+        while (newest == UINT32_MAX) {
+            // Drain to the most recent frame, as Runtime::present_latest does.
+            while (true) {
+                uint32_t idx;
+                const auto &buf = pipeline.try_consume(idx);
+                if (idx == UINT32_MAX) break;
+                if (newest != UINT32_MAX) (void)pipeline.release_buffer(newest);
+                newest = idx;
+                picked = clock_type::now();
+                buf.for_each([&seq](const ege::RenderCommand &cmd) { seq = cmd.color; });
+            }
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(picked - began[seq]).count());
+        spin_for(std::chrono::microseconds(1000)); // present
+        (void)pipeline.release_buffer(newest);
+    }
+    stop.store(true);
+    producer.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    double sum = 0.0;
+    for (double l : latencies) sum += l;
+    state.set_counter("avg_latency_us", sum / static_cast<double>(latencies.size()));
+    state.set_counter("p99_latency_us", latencies[latencies.size() * 99 / 100]);
+    state.set_counter("skipped_recordings", static_cast<double>(skipped.load()));
+}
+
+// One frame through the pipeline on a single thread: acquire, record a
+// clear and 32 rects, submit, consume, decode and release. Measures the
+// hand-off bookkeeping rather than any waiting.
+template<typename Pipeline>
+void round_trip_bench(ege::bench::State &state) {
+    Pipeline pipeline;
+    uint32_t seq = 0;
+    uint64_t decoded = 0;
+    for (auto _ : state) {
+        auto opt = pipeline.begin_frame();
+        if (opt) {
+            auto &buf = opt->get();
+            buf.push_clear(seq);
+            for (int i = 0; i < 32; ++i) buf.push_rect(0, seq, static_cast<int16_t>(i), 0, 8, 8);
+            pipeline.submit_frame();
+        }
+        uint32_t idx;
+        const auto &buf = pipeline.try_consume(idx);
+        if (idx != UINT32_MAX) {
+            decoded += buf.view().for_each([](const ege::RenderCommand &) {});
+            (void)pipeline.release_buffer(idx);
+        }
+        ++seq;
+    }
+    ege::bench::do_not_optimize(decoded);
+    state.set_counter("commands_per_frame", static_cast<double>(decoded) / static_cast<double>(state.iterations()));
+}
+
+EGE_BENCHMARK(pipeline_round_trip_spsc, 200000) {
+    round_trip_bench<ege::SPSCRenderPipeline<1024, 4, 8>>(state);
+}
+
+EGE_BENCHMARK(pipeline_round_trip_mailbox, 200000) {
+    round_trip_bench<ege::MailboxRenderPipeline<1024>>(state);
+}
+
+EGE_BENCHMARK(pipeline_latency_spsc, 500) {
+    latency_bench<ege::SPSCRenderPipeline<1024, 4, 8>>(state);
+}
+
+EGE_BENCHMARK(pipeline_latency_mailbox, 500) {
+    latency_bench<ege::MailboxRenderPipeline<1024>>(state);
+}
+
+} // namespace
@@ -0,0 +1,188 @@
+#include "bench.hpp"
+
+#include <ege/engine/mpsc_queue.hpp>
+#include <ege/engine/spsc_queue.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Waiting loops yield so the benchmarks also finish on a single core, where
+// a pure spin would hold the CPU for a whole scheduler slice.
+
+namespace {
+
+// The SPSCQueue layout before cache-line separation: adjacent indices and an
+// acquire load of the remote index on every operation. Kept here only as the
+// baseline for the two-thread benchmarks below.
+template<typename T, std::size_t Capacity>
+class LegacySPSCQueue {
+public:
+    [[nodiscard]] bool push(const T& v) noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t next = (head + 1) & (Capacity - 1);
+        if (next == tail_.load(std::memory_order_acquire)) return false;
+        buffer_[head] = v;
+        head_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] bool pop(T& out) noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return false;
+        out = buffer_[tail];
+        tail_.store((tail + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+private:
+    T buffer_[Capacity];
+    std::atomic<std::size_t> head_{0};
+    std::atomic<std::size_t> tail_{0};
+};
+
+constexpr std::size_t kQueueCapacity = 1024;
+constexpr std::size_t kBatch = 32;
+
+// One producer thread streams `iterations` values; the measured thread pops them.
+template<typename Queue>
+void throughput_bench(ege::bench::State &state) {
+    static Queue q;
+    const std::size_t total = state.iterations();
+    std::thread producer([total] {
+        for (uint64_t i = 0; i < total; ++i) {
+            while (!q.push(i)) std::this_thread::yield();
+        }
+    });
+    uint64_t sum = 0;
+    for (auto _ : state) {
+        uint64_t v;
+        while (!q.pop(v)) std::this_thread::yield();
+        sum += v;
+    }
+    producer.join();
+    ege::bench::do_not_optimize(sum);
+    state.set_counter("Mitems_per_s", static_cast<double>(total) * 1e3 / state.elapsed_ns());
+}
+
+// Same stream moved in batches of `kBatch` with push_n/pop_n.
+void bulk_throughput_bench(ege::bench::State &state) {
+    static ege::SPSCQueue<uint64_t, kQueueCapacity> q;
+    const std::size_t total = state.iterations() * kBatch;
+    std::thread producer([total] {
+        std::array<uint64_t, kBatch> batch{};
+        uint64_t next = 0;
+        while (next < total) {
+            for (std::size_t i = 0; i < kBatch; ++i) batch[i] = next + i;
+            std::size_t sent = 0;
+            while (sent < kBatch) {
+                const std::size_t n = q.push_n(std::span<const uint64_t>(batch).subspan(sent));
+                if (n == 0) std::this_thread::yield();
+                sent += n;
+            }
+            next += kBatch;
+        }
+    });
+    std::array<uint64_t, kBatch> batch{};
+    uint64_t sum = 0;
+    for (auto _ : state) {
+        std::size_t got = 0;
+        while (got < kBatch) {
+            const std::size_t n = q.pop_n(std::span<uint64_t>(batch).subspan(got));
+            if (n == 0) std::this_thread::yield();
+            got += n;
+        }
+        for (uint64_t v : batch) sum += v;
+    }
+    producer.join();
+    ege::bench::do_not_optimize(sum);
+    state.set_counter("Mitems_per_s", static_cast<double>(total) * 1e3 / state.elapsed_ns());
+}
+
+// Uncontended cost: push and pop on the same thread, so the queue always
+// holds one value and each side's cached index stays valid.
+template<typename Queue>
+void single_thread_bench(ege::bench::State &state) {
+    static Queue q;
+    uint64_t sum = 0;
+    for (auto _ : state) {
+        (void)q.push(sum);
+        uint64_t v = 0;
+        (void)q.pop(v);
+        sum += v + 1;
+    }
+    ege::bench::do_not_optimize(sum);
+}
+
+// Round trip: the measured thread sends a value and waits for an echo
+// thread to send it back. One iteration = two queue hand-offs.
+template<typename Queue>
+void ping_pong_bench(ege::bench::State &state) {
+    static Queue ping;
+    static Queue pong;
+    std::atomic<bool> stop{false};
+    std::thread echo([&stop] {
+        uint64_t v;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (ping.pop(v)) { while (!pong.push(v)) std::this_thread::yield(); }
+            else std::this_thread::yield();
+        }
+    });
+    uint64_t seq = 0;
+    for (auto _ : state) {
+        while (!ping.push(seq)) std::this_thread::yield();
+        uint64_t v;
+        while (!pong.pop(v)) std::this_thread::yield();
+        ++seq;
+    }
+    stop.store(true, std::memory_order_relaxed);
+    echo.join();
+    ege::bench::do_not_optimize(seq);
+}
+
+// `Producers` threads share the stream; the measured thread drains in batches.
+template<int Producers>
+void mpsc_throughput_bench(ege::bench::State &state) {
+    static ege::MPSCQueue<uint64_t, kQueueCapacity> q;
+    const std::size_t per_producer = state.iterations() * kBatch / Producers;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < Producers; ++p) {
+        producers.emplace_back([per_producer] {
+            for (uint64_t i = 0; i < per_producer; ++i) {
+                while (!q.push(i)) std::this_thread::yield();
+            }
+        });
+    }
+    std::array<uint64_t, kBatch> batch{};
+    uint64_t sum = 0;
+    for (auto _ : state) {
+        std::size_t got = 0;
+        while (got < kBatch) {
+            const std::size_t n = q.pop_n(std::span<uint64_t>(batch).subspan(got));
+            if (n == 0) std::this_thread::yield();
+            got += n;
+        }
+        for (uint64_t v : batch) sum += v;
+    }
+    for (auto &t : producers) t.join();
+    ege::bench::do_not_optimize(sum);
+    state.set_counter("Mitems_per_s", static_cast<double>(state.iterations() * kBatch) * 1e3 / state.elapsed_ns());
+}
+
+using Legacy = LegacySPSCQueue<uint64_t, kQueueCapacity>;
+using Padded = ege::SPSCQueue<uint64_t, kQueueCapacity>;
+
+} // namespace
+
+EGE_BENCHMARK(spsc_push_pop_1_thread_legacy, 4000000) { single_thread_bench<Legacy>(state); }
+EGE_BENCHMARK(spsc_push_pop_1_thread_padded, 4000000) { single_thread_bench<Padded>(state); }
+EGE_BENCHMARK(spsc_throughput_legacy, 4000000) { throughput_bench<Legacy>(state); }
+EGE_BENCHMARK(spsc_throughput_padded, 4000000) { throughput_bench<Padded>(state); }
+EGE_BENCHMARK(spsc_throughput_bulk32, 4000000 / kBatch) { bulk_throughput_bench(state); }
+EGE_BENCHMARK(spsc_round_trip_legacy, 100000) { ping_pong_bench<Legacy>(state); }
+EGE_BENCHMARK(spsc_round_trip_padded, 100000) { ping_pong_bench<Padded>(state); }
+EGE_BENCHMARK(mpsc_throughput_1_producer, 4000000 / kBatch) { mpsc_throughput_bench<1>(state); }
+EGE_BENCHMARK(mpsc_throughput_4_producers, 4000000 / kBatch) { mpsc_throughput_bench<4>(state); }
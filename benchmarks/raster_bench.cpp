@@ -0,0 +1,274 @@
+#include "bench.hpp"
+
+#include <ege/engine/command_buffer.hpp>
+#include <ege/raster/palette.hpp>
+#include <ege/raster/tile_rasterizer.hpp>
+#include <ege/raster/span_kernels.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kW = 320;
+constexpr std::size_t kH = 240;
+
+// The SDL example with its menu open: background, sprite rect, translucent
+// full-screen overlay and two buttons.
+void record_menu(ege::MemoryCommandBuffer<1024> &buf) {
+    buf.push_clear(0xFF001144);
+    buf.push_rect(0, 0xFFFFAA00, 40, 40, 50, 30);
+    buf.push_rect(0, 0x80000000, 0, 0, 320, 240);
+    buf.push_rect(0, 0xFFFFAA00, 50, 82, 220, 30);
+    buf.push_rect(0, 0xFFC0C0C0, 50, 120, 220, 30);
+}
+
+// Overdraw-heavy UI: clear plus 60 panels of assorted sizes.
+void record_overdraw(ege::MemoryCommandBuffer<1024> &buf) {
+    std::mt19937 rng(3u);
+    std::uniform_int_distribution<int> x(-20, 300), y(-20, 220), w(20, 200), h(20, 160);
+    buf.push_clear(0xFF000000);
+    for (int i = 0; i < 60; ++i) {
+        buf.push_rect(0, 0xFF000000u | static_cast<uint32_t>(i * 0x030507),
+                      static_cast<int16_t>(x(rng)), static_cast<int16_t>(y(rng)),
+                      static_cast<int16_t>(w(rng)), static_cast<int16_t>(h(rng)));
+    }
+}
+
+template<typename Record>
+void reference_bench(ege::bench::State &state, Record record) {
+    std::vector<uint32_t> pixels(kW * kH);
+    ege::MemoryCommandBuffer<1024> buf;
+    record(buf);
+    ege::raster::RasterStats stats;
+    for (auto _ : state) {
+        ege::raster::rasterize_reference(buf.view(), {pixels.data(), kW, kH, kW}, &stats);
+        ege::bench::do_not_optimize(pixels.data());
+    }
+    state.set_counter("pixels_written", static_cast<double>(stats.pixels_written));
+    state.set_counter("writes_per_pixel", static_cast<double>(stats.pixels_written) / (kW * kH));
+}
+
+template<typename Record>
+void tiled_bench(ege::bench::State &state, Record record) {
+    std::vector<uint32_t> pixels(kW * kH);
+    ege::MemoryCommandBuffer<1024> buf;
+    record(buf);
+    ege::raster::TileRasterizer raster(kW, kH);
+    for (auto _ : state) {
+        raster.render(buf.view(), {pixels.data(), kW, kH, kW});
+        ege::bench::do_not_optimize(pixels.data());
+    }
+    const auto &stats = raster.stats();
+    state.set_counter("pixels_written", static_cast<double>(stats.pixels_written));
+    state.set_counter("writes_per_pixel", static_cast<double>(stats.pixels_written) / (kW * kH));
+}
+
+EGE_BENCHMARK(raster_menu_reference, 2000) { reference_bench(state, record_menu); }
+EGE_BENCHMARK(raster_menu_tiled, 2000) { tiled_bench(state, record_menu); }
+EGE_BENCHMARK(raster_overdraw_reference, 500) { reference_bench(state, record_overdraw); }
+EGE_BENCHMARK(raster_overdraw_tiled, 500) { tiled_bench(state, record_overdraw); }
+
+} // namespace
+
+namespace {
+
+// One 320-pixel scanline per iteration, for every kernel the CPU supports.
+const bool span_kernels_registered = [] {
+    for (const auto &k : ege::raster::available_span_kernels()) {
+        const std::string name = k.name;
+        ege::bench::register_benchmark("span_fill/" + name, 200000, [k](ege::bench::State &state) {
+            std::vector<uint32_t> row(kW, 0u);
+            for (auto _ : state) {
+                k.fill(row.data(), row.size(), 0xFF336699u);
+                ege::bench::do_not_optimize(row.data());
+            }
+            state.set_counter("pixels", static_cast<double>(kW));
+        });
+        ege::bench::register_benchmark("span_blend/" + name, 200000, [k](ege::bench::State &state) {
+            std::vector<uint32_t> row(kW, 0xFF808080u);
+            for (auto _ : state) {
+                k.blend(row.data(), row.size(), 0x80336699u);
+                ege::bench::do_not_optimize(row.data());
+            }
+            state.set_counter("pixels", static_cast<double>(kW));
+        });
+    }
+    return true;
+}();
+
+} // namespace
+
+namespace {
+
+// Mostly static UI where only a small cursor moves each frame.
+template<bool Incremental>
+void cursor_bench(ege::bench::State &state) {
+    std::vector<uint32_t> pixels(kW * kH);
+    ege::raster::TileRasterizer raster(kW, kH);
+    ege::MemoryCommandBuffer<1024> buf;
+    uint64_t dirty_pixels = 0;
+    int frame = 0;
+    for (auto _ : state) {
+        state.pause_timing();
+        buf.reset();
+        record_menu(buf);
+        buf.push_rect(0, 0xFFFFFFFF, static_cast<int16_t>(frame * 3 % 300), static_cast<int16_t>(frame * 2 % 220), 4, 4);
+        ++frame;
+        state.resume_timing();
+        if constexpr (Incremental) raster.render_incremental(buf.view(), {pixels.data(), kW, kH, kW});
+        else raster.render(buf.view(), {pixels.data(), kW, kH, kW});
+        for (const auto &r : raster.dirty_rects()) dirty_pixels += static_cast<uint64_t>(r.w) * static_cast<uint64_t>(r.h);
+        ege::bench::do_not_optimize(pixels.data());
+    }
+    state.set_counter("uploaded_pixels_per_frame", static_cast<double>(dirty_pixels) / static_cast<double>(state.iterations()));
+}
+
+EGE_BENCHMARK(raster_cursor_full, 2000) { cursor_bench<false>(state); }
+EGE_BENCHMARK(raster_cursor_incremental, 2000) { cursor_bench<true>(state); }
+
+} // namespace
+
+namespace {
+
+// 64 16x16 sprites with a colour-keyed outline, half of them mirrored,
+// recorded either as sprite commands or the old way as one 1x1 rect per
+// opaque pixel.
+constexpr std::size_t kSprites = 64;
+constexpr uint32_t kKey = 0xFFFF00FF;
+
+struct SpriteSheet {
+    std::vector<uint32_t> pixels;
+    ege::SpriteAtlas atlas;
+    SpriteSheet() : pixels(16 * 16) {
+        for (uint32_t y = 0; y < 16; ++y)
+            for (uint32_t x = 0; x < 16; ++x)
+                pixels[y * 16 + x] = (x == 0 || y == 0 || x == 15 || y == 15) ? kKey : 0xFF000000u | (x << 20) | (y << 12);
+        atlas = ege::SpriteAtlas{pixels.data(), 16, 16, 16, kKey, true};
+    }
+};
+
+template<bool AsSprites, std::size_t N>
+void record_sprites(ege::MemoryCommandBuffer<N> &buf, const SpriteSheet &sheet) {
+    buf.reset();
+    buf.push_clear(0xFF000000);
+    for (std::size_t i = 0; i < kSprites; ++i) {
+        const auto x = static_cast<int16_t>((i * 37) % (kW - 16));
+        const auto y = static_cast<int16_t>((i * 53) % (kH - 16));
+        const bool flip = (i & 1) != 0;
+        if constexpr (AsSprites) {
+            buf.push_sprite(0, 0, ege::SpriteFrame{0, 0, 16, 16}, x, y, flip ? ege::SpriteFlipX : 0);
+        } else {
+            for (int16_t sy = 0; sy < 16; ++sy)
+                for (int16_t sx = 0; sx < 16; ++sx) {
+                    const uint32_t v = sheet.pixels[static_cast<std::size_t>(sy * 16 + (flip ? 15 - sx : sx))];
+                    if (v != kKey) buf.push_rect(0, v, static_cast<int16_t>(x + sx), static_cast<int16_t>(y + sy), 1, 1);
+                }
+        }
+    }
+}
+
+template<bool AsSprites>
+void sprite_bench(ege::bench::State &state) {
+    static ege::MemoryCommandBuffer<1u << 20> buf;
+    static const SpriteSheet sheet;
+    std::vector<uint32_t> pixels(kW * kH);
+    ege::raster::TileRasterizer raster(kW, kH);
+    raster.set_atlas(0, &sheet.atlas);
+    for (auto _ : state) {
+        record_sprites<AsSprites>(buf, sheet);
+        raster.render(buf.view(), {pixels.data(), kW, kH, kW});
+        ege::bench::do_not_optimize(pixels.data());
+    }
+    state.set_counter("commands", static_cast<double>(raster.stats().commands));
+    state.set_counter("encoded_bytes", static_cast<double>(buf.size()));
+}
+
+EGE_BENCHMARK(raster_sprites_as_pixel_rects, 50) { sprite_bench<false>(state); }
+EGE_BENCHMARK(raster_sprites_blit, 2000) { sprite_bench<true>(state); }
+
+} // namespace
+
+namespace {
+
+// Overdraw scene rendered into an 8-bit indexed framebuffer, alone and with a
+// full-screen LUT expansion (the cost of a palette swap) on top.
+void indexed_bench(ege::bench::State &state, bool expand) {
+    std::vector<uint8_t> indices(kW * kH);
+    std::vector<uint32_t> out(kW * kH);
+    ege::MemoryCommandBuffer<1024> buf;
+    record_overdraw(buf);
+    ege::raster::Palette palette;
+    for (uint32_t i = 0; i < 256; ++i) palette.set(static_cast<uint8_t>(i), 0xFF000000u | (i * 0x010101u));
+    ege::raster::TileRasterizer raster(kW, kH);
+    const ege::raster::IndexedTarget target{indices.data(), kW, kH, kW};
+    for (auto _ : state) {
+        raster.render(buf.view(), target);
+        if (expand) {
+            palette.rotate(1, 255, 1);
+            ege::raster::expand_indexed(target, palette, {0, 0, kW, kH}, out.data(), kW);
+        }
+        ege::bench::do_not_optimize(out.data());
+        ege::bench::do_not_optimize(indices.data());
+    }
+    state.set_counter("framebuffer_bytes", static_cast<double>(indices.size()));
+    state.set_counter("argb_framebuffer_bytes", static_cast<double>(kW * kH * sizeof(uint32_t)));
+}
+
+EGE_BENCHMARK(raster_overdraw_indexed, 500) { indexed_bench(state, false); }
+EGE_BENCHMARK(raster_overdraw_indexed_expand, 500) { indexed_bench(state, true); }
+
+} // namespace
+
+namespace {
+
+// 4000 2x2 particles over a clear, as separate rects or one batch.
+template<bool Batched>
+void particle_raster_bench(ege::bench::State &state) {
+    static ege::MemoryCommandBuffer<64 * 1024> buf;
+    std::mt19937 rng(21u);
+    std::uniform_int_distribution<int> x(0, 317), y(0, 237);
+    std::vector<ege::RectInstance> particles(4000);
+    for (auto &r : particles) r = {static_cast<int16_t>(x(rng)), static_cast<int16_t>(y(rng)), 2, 2};
+    buf.reset();
+    buf.push_clear(0xFF000000);
+    if constexpr (Batched) buf.push_rect_batch(1, 0xFFFFFFFF, particles);
+    else for (const auto &r : particles) buf.push_rect(1, 0xFFFFFFFF, r.x, r.y, r.w, r.h);
+    std::vector<uint32_t> pixels(kW * kH);
+    ege::raster::TileRasterizer raster(kW, kH);
+    for (auto _ : state) {
+        raster.render(buf.view(), {pixels.data(), kW, kH, kW});
+        ege::bench::do_not_optimize(pixels.data());
+    }
+    state.set_counter("encoded_bytes", static_cast<double>(buf.size()));
+}
+
+EGE_BENCHMARK(raster_particles_rects, 500) { particle_raster_bench<false>(state); }
+EGE_BENCHMARK(raster_particles_batch, 500) { particle_raster_bench<true>(state); }
+
+} // namespace
+
+namespace {
+
+// World of 400 tiles on layer 0 under an opaque menu panel on layer 4 that
+// hides most of it; the panel is recorded first, as a UI layer often is.
+EGE_BENCHMARK(raster_layered_menu, 500) {
+    static ege::MemoryCommandBuffer<16 * 1024> buf;
+    buf.reset();
+    buf.push_rect(4, 0xFF303030, 16, 16, 288, 208);
+    for (int16_t y = 0; y < 240; y = static_cast<int16_t>(y + 12))
+        for (int16_t x = 0; x < 320; x = static_cast<int16_t>(x + 16))
+            buf.push_rect(0, 0xFF000000u | static_cast<uint32_t>(x * 0x0101), x, y, 16, 12);
+    std::vector<uint32_t> pixels(kW * kH);
+    ege::raster::TileRasterizer raster(kW, kH);
+    for (auto _ : state) {
+        raster.render(buf.view(), {pixels.data(), kW, kH, kW});
+        ege::bench::do_not_optimize(pixels.data());
+    }
+    state.set_counter("commands", static_cast<double>(raster.stats().commands));
+    state.set_counter("occluded_commands", static_cast<double>(raster.stats().occluded_commands));
+    state.set_counter("writes_per_pixel", static_cast<double>(raster.stats().pixels_written) / (kW * kH));
+}
+
+} // namespace
@@ -0,0 +1,44 @@
+#include "bench.hpp"
+
+#include <ege/backends/headless/headless_backend.hpp>
+#include <ege/runtime.hpp>
+
+namespace {
+
+// A game-like frame: clear, 40 world tiles, a moving player and a HUD bar.
+struct SceneLayer : ege::Layer {
+    int frame = 0; // run() restarts its frame count, so keep our own
+    void on_render(int) override {
+        ++frame;
+        cmdbuf_->push_clear(0xFF001144);
+        for (int i = 0; i < 40; ++i) {
+            cmdbuf_->push_rect(0, 0xFF204020u + static_cast<uint32_t>(i),
+                               static_cast<int16_t>((i % 10) * 32), static_cast<int16_t>((i / 10) * 32 + 80), 30, 30);
+        }
+        cmdbuf_->push_rect(1, 0xFFFFAA00, static_cast<int16_t>(frame % 300), 120, 16, 16);
+        cmdbuf_->push_rect(2, 0xC0000000, 0, 0, 320, 20);
+    }
+};
+
+// One iteration is one whole runtime frame on the headless backend: poll
+// scripted input, dispatch, update, record, submit and rasterize.
+EGE_BENCHMARK(runtime_headless_frame, 2000) {
+    ege::backend::HeadlessBackend backend;
+    backend.init(320, 240);
+    ege::SPSCRenderPipeline<1024, 4, 8> pipeline;
+    ege::PhysicsSystem physics;
+    ege::RuntimeConfig config;
+    config.pacing.target_fps = 0.0;
+    ege::Runtime rt(backend, pipeline, physics, config);
+    SceneLayer layer;
+    layer.show();
+    rt.push_layer(&layer);
+    for (auto _ : state) {
+        backend.quit_at(backend.frames_polled());
+        rt.run();
+    }
+    state.set_counter("frames", static_cast<double>(backend.frames_presented()));
+    state.set_counter("dirty_tiles", static_cast<double>(backend.raster_stats().dirty_tiles));
+}
+
+} // namespace
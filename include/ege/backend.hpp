@@ -1,21 +1,24 @@
 #pragma once
-#include <vector>
 #include <cstddef>
+#include <span>
 #include "ege/engine/render_command.hpp"
 #include "ege/engine/command_buffer.hpp"
 #include "ege/engine/event.hpp"
 
 namespace ege { namespace backend {
+// Event collection fills a caller-provided span and returns how many events
+// were written; events that do not fit stay queued for the next call, so a
+// frame never needs heap storage for its input.
 template<typename L>
-concept BackendConcept = requires(L l, std::size_t w, std::size_t h, const ege::FrameBuffer<1024>& frame, std::vector<ege::Event>& events, int sample_rate, uint32_t sound_id, float frequency, uint32_t duration_ms, ege::Event &out) {
+concept BackendConcept = requires(L l, std::size_t w, std::size_t h, const ege::CommandView& frame, std::span<ege::Event> events, int sample_rate, uint32_t sound_id, float frequency, uint32_t duration_ms, ege::Event &out) {
     { l.init(w, h) } -> std::convertible_to<bool>;
     { l.shutdown() } -> std::same_as<void>;
     { l.present(frame) } -> std::same_as<void>;
-    { l.poll_input(events) } -> std::same_as<void>;
+    { l.poll_input(events) } -> std::convertible_to<std::size_t>;
     { l.open_audio(sample_rate) } -> std::convertible_to<bool>;
     { l.trigger_sound(sound_id, frequency, duration_ms) } -> std::same_as<void>;
     { l.try_pop_event(out) } -> std::convertible_to<bool>;
-    { l.drain_events(events) } -> std::same_as<void>;
+    { l.drain_events(events) } -> std::convertible_to<std::size_t>;
 };
 
 } }
@@ -1,21 +1,56 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
+#include <ege/engine/memory_registry.hpp>
 
 namespace ege {
 
+// Bump allocator over a caller-provided buffer. Besides `used()` it keeps
+// statistics that survive `reset()` (peak usage, allocation and failure
+// counts, bytes lost to alignment) so arenas can be sized from real runs.
+// A named arena is listed in `memory::report()` while it exists.
 class StaticArena {
 public:
-    StaticArena(void* buffer, std::size_t size) noexcept;
+    StaticArena(void* buffer, std::size_t size, const char* name = nullptr) noexcept;
+    ~StaticArena();
+    StaticArena(const StaticArena&) = delete;
+    StaticArena& operator=(const StaticArena&) = delete;
+
     [[nodiscard]] void* allocate(std::size_t size, std::size_t align = alignof(std::max_align_t)) noexcept;
     void reset() noexcept;
     [[nodiscard]] std::size_t capacity() const noexcept;
     [[nodiscard]] std::size_t used() const noexcept;
 
+    [[nodiscard]] const char* name() const noexcept { return m_entry.name; }
+    [[nodiscard]] std::size_t peak() const noexcept { return m_peak; }
+    [[nodiscard]] uint64_t allocations() const noexcept { return m_allocations; }
+    [[nodiscard]] uint64_t failed_allocations() const noexcept { return m_failed; }
+    [[nodiscard]] std::size_t wasted_alignment() const noexcept { return m_wasted; }
+    // Zero the statistics above (peak restarts from the current usage).
+    void clear_stats() noexcept;
+
+    // Debug canary: fill the free part of the buffer with `pattern` now and
+    // on every reset. A write past the end of the newest allocation then
+    // shows up in `check_canary()` (or at the next allocation, counted in
+    // `canary_violations()`). Costs a pass over the memory handed out.
+    void enable_canary(uint8_t pattern = 0xCD) noexcept;
+    [[nodiscard]] bool check_canary() const noexcept;
+    [[nodiscard]] uint64_t canary_violations() const noexcept { return m_canary_violations; }
+
+    [[nodiscard]] MemoryUsage usage() const noexcept;
+
 private:
     uint8_t* m_start;
     uint8_t* m_ptr;
     uint8_t* m_end;
+    std::size_t m_peak = 0;
+    uint64_t m_allocations = 0;
+    uint64_t m_failed = 0;
+    std::size_t m_wasted = 0;
+    bool m_canary = false;
+    uint8_t m_canary_pattern = 0;
+    uint64_t m_canary_violations = 0;
+    MemoryEntry m_entry;
 };
 
 } // namespace ege
@@ -3,30 +3,428 @@
 #include <cstdint>
 #include <cstring>
 #include <cassert>
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <span>
+#include <utility>
+#include "allocator.hpp"
 #include "render_command.hpp"
+#include "sprite.hpp"
 
 namespace ege {
 
+// Byte layout of a command stream. Streams start out Fixed; a Version tag
+// switches the decoder to another encoding for the rest of the stream, so
+// an older decoder stops at the tag instead of misreading the commands.
+enum class CommandEncoding : uint8_t {
+    // Self-contained commands: clear 5 bytes, rect 14, sprite 16.
+    Fixed = 1,
+    // Rects inherit layer and colour from state commands and store varint
+    // coordinates relative to the previous rect (typically 5-9 bytes).
+    // Clears and sprites keep their fixed layout.
+    Compact = 2,
+};
+
+namespace detail {
+
+// Opcodes beyond RenderCommandType, which doubles as the opcode of the
+// fixed-layout commands.
+enum class StreamOp : uint8_t {
+    Version = 0x10,     // encoding(1)
+    SetLayer = 0x11,    // layer(1), for subsequent compact rects
+    SetColor = 0x12,    // color(4), for subsequent compact rects
+    CompactRect = 0x13, // varint zigzag dx, dy, w, h; dx/dy from the previous compact rect
+};
+
+// Longest compact rect: opcode plus four 3-byte varints.
+inline constexpr std::size_t kMaxCompactRect = 1 + 4 * 3;
+
+// Stream state shared by the encoder and decoder: the active encoding, the
+// inherited layer/colour and the previous compact rect's origin.
+struct StreamState {
+    CommandEncoding encoding = CommandEncoding::Fixed;
+    uint8_t layer = 0;
+    uint32_t color = 0;
+    int16_t x = 0;
+    int16_t y = 0;
+};
+
+inline uint32_t zigzag(int32_t v) noexcept {
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+inline int32_t unzigzag(uint32_t v) noexcept {
+    return static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1u);
+}
+
+inline uint8_t* put_varint(uint8_t* p, uint32_t v) noexcept {
+    while (v >= 0x80u) {
+        *p++ = static_cast<uint8_t>(v | 0x80u);
+        v >>= 7;
+    }
+    *p++ = static_cast<uint8_t>(v);
+    return p;
+}
+
+// Reads a varint of at most 3 bytes (enough for any zigzagged int16 delta).
+inline bool get_varint(const uint8_t*& p, const uint8_t* end, uint32_t& v) noexcept {
+    if (p < end && *p < 0x80u) { // common case: one byte
+        v = *p++;
+        return true;
+    }
+    v = 0;
+    for (uint32_t shift = 0; shift < 21; shift += 7) {
+        if (p >= end) return false;
+        const uint8_t b = *p++;
+        v |= static_cast<uint32_t>(b & 0x7Fu) << shift;
+        if ((b & 0x80u) == 0) return true;
+    }
+    return false;
+}
+
+// Decode the next drawable command starting at `p`, applying any version or
+// state commands before it to `state`. On success stores the command in
+// `out`, advances `p` past it and returns true. Returns false on truncated
+// data, an unknown opcode or version, or a compact opcode in a Fixed stream;
+// `p` is then left unchanged. State commands that run up to `end` without a
+// drawable command after them are consumed (`p == end`), so a segment that
+// holds only state reads as empty rather than malformed.
+inline bool decode_command(const uint8_t*& p, const uint8_t* end, RenderCommand& out, StreamState& state) noexcept {
+    const uint8_t* q = p;
+    for (;;) {
+        if (q >= end) {
+            p = q;
+            return false;
+        }
+        const std::size_t avail = static_cast<std::size_t>(end - q);
+        const uint8_t opcode = q[0];
+        if (opcode == static_cast<uint8_t>(RenderCommandType::Rect)) {
+            constexpr std::size_t chunk = 1 + 1 + 4 + 2 + 2 + 2 + 2;
+            if (avail < chunk) return false; // malformed
+            out = RenderCommand{};
+            out.type = RenderCommandType::Rect;
+            out.layer = q[1];
+            std::memcpy(&out.color, q + 2, 4);
+            std::memcpy(&out.rect.x, q + 6, 2);
+            std::memcpy(&out.rect.y, q + 8, 2);
+            std::memcpy(&out.rect.w, q + 10, 2);
+            std::memcpy(&out.rect.h, q + 12, 2);
+            p = q + chunk;
+            return true;
+        }
+        if (opcode == static_cast<uint8_t>(StreamOp::CompactRect) && state.encoding == CommandEncoding::Compact) {
+            const uint8_t* r = q + 1;
+            uint32_t dx, dy, w, h;
+            if (!get_varint(r, end, dx) || !get_varint(r, end, dy) ||
+                !get_varint(r, end, w) || !get_varint(r, end, h)) return false; // malformed
+            state.x = static_cast<int16_t>(state.x + unzigzag(dx));
+            state.y = static_cast<int16_t>(state.y + unzigzag(dy));
+            out = RenderCommand{};
+            out.type = RenderCommandType::Rect;
+            out.layer = state.layer;
+            out.color = state.color;
+            out.rect.x = state.x;
+            out.rect.y = state.y;
+            out.rect.w = static_cast<int16_t>(unzigzag(w));
+            out.rect.h = static_cast<int16_t>(unzigzag(h));
+            p = r;
+            return true;
+        }
+        if (opcode == static_cast<uint8_t>(RenderCommandType::Clear)) {
+            constexpr std::size_t chunk = 1 + 4;
+            if (avail < chunk) return false; // malformed
+            out = RenderCommand{};
+            out.type = RenderCommandType::Clear;
+            std::memcpy(&out.color, q + 1, 4);
+            p = q + chunk;
+            return true;
+        }
+        if (opcode == static_cast<uint8_t>(RenderCommandType::Sprite)) {
+            constexpr std::size_t chunk = 1 + 1 + 1 + 1 + 2 + 2 + 2 + 2 + 2 + 2;
+            if (avail < chunk) return false; // malformed
+            out = RenderCommand{};
+            out.type = RenderCommandType::Sprite;
+            out.layer = q[1];
+            out.sprite.atlas = q[2];
+            out.sprite.flags = q[3];
+            std::memcpy(&out.sprite.sx, q + 4, 2);
+            std::memcpy(&out.sprite.sy, q + 6, 2);
+            std::memcpy(&out.rect.w, q + 8, 2);
+            std::memcpy(&out.rect.h, q + 10, 2);
+            std::memcpy(&out.rect.x, q + 12, 2);
+            std::memcpy(&out.rect.y, q + 14, 2);
+            p = q + chunk;
+            return true;
+        }
+        if (opcode == static_cast<uint8_t>(RenderCommandType::RectBatch)) {
+            constexpr std::size_t header = 1 + 1 + 4 + 2;
+            if (avail < header) return false; // malformed
+            uint16_t count;
+            std::memcpy(&count, q + 6, 2);
+            const std::size_t chunk = header + std::size_t{count} * sizeof(RectInstance);
+            if (avail < chunk) return false; // malformed
+            out = RenderCommand{};
+            out.type = RenderCommandType::RectBatch;
+            out.layer = q[1];
+            std::memcpy(&out.color, q + 2, 4);
+            out.batch.data = q + header;
+            out.batch.count = count;
+            p = q + chunk;
+            return true;
+        }
+        if (opcode == static_cast<uint8_t>(StreamOp::Version)) {
+            if (avail < 2) return false;
+            if (q[1] != static_cast<uint8_t>(CommandEncoding::Fixed) &&
+                q[1] != static_cast<uint8_t>(CommandEncoding::Compact)) return false; // unknown version
+            state = StreamState{};
+            state.encoding = static_cast<CommandEncoding>(q[1]);
+            q += 2;
+            continue;
+        }
+        if (state.encoding != CommandEncoding::Compact) return false;
+        if (opcode == static_cast<uint8_t>(StreamOp::SetLayer)) {
+            if (avail < 2) return false;
+            state.layer = q[1];
+            q += 2;
+            continue;
+        }
+        if (opcode == static_cast<uint8_t>(StreamOp::SetColor)) {
+            if (avail < 5) return false;
+            std::memcpy(&state.color, q + 1, 4);
+            q += 5;
+            continue;
+        }
+        // unknown opcode, stop
+        return false;
+    }
+}
+
+} // namespace detail
+
+// Overflow chunk of a MemoryCommandBuffer, allocated from its StaticArena.
+// The encoded bytes follow the header. Commands never straddle chunks.
+struct CommandChunk {
+    CommandChunk* next;
+    std::size_t size;
+    std::size_t capacity;
+
+    [[nodiscard]] uint8_t* data() noexcept { return reinterpret_cast<uint8_t*>(this + 1); }
+    [[nodiscard]] const uint8_t* data() const noexcept { return reinterpret_cast<const uint8_t*>(this + 1); }
+};
+
+// What a MemoryCommandBuffer does when its base block and overflow arena
+// cannot take another command. Dropped commands are counted either way.
+enum class OverflowPolicy : uint8_t {
+    // Drop only the commands that do not fit.
+    DropNewest,
+    // Keep the last `reserve` arena bytes for layers at or above the
+    // configured `protected_layer`: once a new chunk would dip into the
+    // reserve, commands on lower layers (typically background detail) are
+    // dropped so HUD and foreground layers still fit, whatever order the
+    // layers are recorded in.
+    DropLowestLayer,
+};
+
+// Read-only view over a binary-encoded command stream in either encoding,
+// optionally continued in a chain of overflow chunks. Iterating decodes one
+// command at a time straight from the encoded bytes, so consumers (backends)
+// can walk a frame without materialising a FrameBuffer. Iteration stops at the
+// first malformed or unknown command. The view does not own the bytes; it is
+// valid as long as the buffer it came from is neither written nor released.
+class CommandView {
+public:
+    CommandView() noexcept = default;
+    CommandView(const uint8_t* data, std::size_t size) noexcept : data_(data), size_(size), total_(size) {}
+    CommandView(const uint8_t* data, std::size_t size, const CommandChunk* chunks, std::size_t total) noexcept
+        : data_(data), size_(size), chunks_(chunks), total_(total) {}
+
+    class iterator {
+    public:
+        using value_type = RenderCommand;
+        using difference_type = std::ptrdiff_t;
+        using reference = const RenderCommand&;
+        using pointer = const RenderCommand*;
+
+        iterator() noexcept = default;
+        iterator(const uint8_t* p, const uint8_t* end, const CommandChunk* next) noexcept
+            : p_(p), end_(end), next_(next) { advance(); }
+
+        reference operator*() const noexcept { return cmd_; }
+        pointer operator->() const noexcept { return &cmd_; }
+        iterator& operator++() noexcept { advance(); return *this; }
+        void operator++(int) noexcept { advance(); }
+        bool operator==(const iterator& o) const noexcept { return cur_ == o.cur_; }
+
+    private:
+        // `cur_` marks the start of the current command; the end state is
+        // `cur_ == nullptr`, so a stream that stops early compares equal to end().
+        void advance() noexcept {
+            for (;;) {
+                cur_ = p_;
+                if (detail::decode_command(p_, end_, cmd_, state_)) return;
+                if (p_ != end_ || next_ == nullptr) break; // malformed or done
+                p_ = next_->data();
+                end_ = p_ + next_->size;
+                next_ = next_->next;
+            }
+            cur_ = nullptr;
+            p_ = end_;
+            next_ = nullptr;
+        }
+
+        const uint8_t* p_ = nullptr;
+        const uint8_t* end_ = nullptr;
+        const CommandChunk* next_ = nullptr;
+        const uint8_t* cur_ = nullptr;
+        RenderCommand cmd_{};
+        detail::StreamState state_{};
+    };
+
+    [[nodiscard]] iterator begin() const noexcept { return iterator(data_, data_ + size_, chunks_); }
+    [[nodiscard]] iterator end() const noexcept { return iterator(); }
+
+    // Call `visitor(const RenderCommand&)` for every command. Returns the
+    // number of commands visited.
+    template<typename Visitor>
+    std::size_t for_each(Visitor&& visitor) const {
+        const uint8_t* p = data_;
+        const uint8_t* end = data_ + size_;
+        const CommandChunk* next = chunks_;
+        RenderCommand cmd{};
+        detail::StreamState state{};
+        std::size_t n = 0;
+        for (;;) {
+            while (detail::decode_command(p, end, cmd, state)) {
+                visitor(static_cast<const RenderCommand&>(cmd));
+                ++n;
+            }
+            if (p != end || next == nullptr) return n;
+            p = next->data();
+            end = p + next->size;
+            next = next->next;
+        }
+    }
+
+    // First segment of the stream; overflow chunks follow via `chunks()`.
+    [[nodiscard]] const uint8_t* data() const noexcept { return data_; }
+    [[nodiscard]] const CommandChunk* chunks() const noexcept { return chunks_; }
+    // Encoded bytes across all segments.
+    [[nodiscard]] std::size_t size() const noexcept { return total_; }
+    [[nodiscard]] bool empty() const noexcept { return total_ == 0; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+    const CommandChunk* chunks_ = nullptr;
+    std::size_t total_ = 0;
+};
+
 // Compact, memory-backed command buffer. Fixed-size byte buffer that stores
 // binary-encoded render commands to minimize memory overhead and improve cache.
+// `set_encoding(CommandEncoding::Compact)` roughly halves the size of rect-heavy
+// frames; see CommandEncoding.
+//
+// With a viewport set (`set_viewport`), geometry that lies entirely outside
+// it is rejected before it takes buffer space and rects are trimmed to it;
+// see `culled_commands()` / `trimmed_commands()`.
+//
+// A full buffer never writes out of bounds: commands that do not fit are
+// dropped and counted in `dropped_commands()`. With `set_overflow_arena` the
+// stream instead continues in chunks allocated from a StaticArena that the
+// buffer resets on every `reset()`, so the arena must belong to this buffer
+// alone and live as long as it does.
 template<std::size_t Capacity>
 class MemoryCommandBuffer {
 public:
+    static_assert(Capacity >= 2, "room for at least the version tag");
+
+    // Instances one RectBatch command can hold (16-bit count).
+    static constexpr std::size_t kMaxRectBatch = UINT16_MAX;
+
     MemoryCommandBuffer() noexcept : writable_(true) { reset(); }
     explicit MemoryCommandBuffer(bool writable) noexcept : writable_(writable) { reset(); }
 
-    void reset() noexcept { size_ = 0; }
+    void reset() noexcept {
+        peak_size_ = std::max(peak_size_, size());
+        dropped_total_ += dropped_;
+        size_ = 0;
+        state_ = detail::StreamState{};
+        state_.encoding = encoding_;
+        head_ = nullptr;
+        tail_ = nullptr;
+        chunk_bytes_ = 0;
+        dropped_ = 0;
+        culled_ = 0;
+        trimmed_ = 0;
+        if (arena_ != nullptr) arena_->reset();
+    }
+
+    // Select the encoding of subsequent commands; clears the buffer. The
+    // setting survives `reset()`.
+    void set_encoding(CommandEncoding encoding) noexcept {
+        encoding_ = encoding;
+        reset();
+    }
+    [[nodiscard]] CommandEncoding encoding() const noexcept { return encoding_; }
+
+    // Continue the stream in `chunk_size`-byte chunks from `arena` once the
+    // base block is full (nullptr disables overflow). `reserve` and
+    // `protected_layer` are used by OverflowPolicy::DropLowestLayer: layers
+    // below `protected_layer` never allocate into the reserve. Clears the
+    // buffer.
+    void set_overflow_arena(StaticArena* arena, std::size_t chunk_size = Capacity,
+                            OverflowPolicy policy = OverflowPolicy::DropNewest, std::size_t reserve = 0,
+                            uint8_t protected_layer = 1) noexcept {
+        arena_ = arena;
+        chunk_size_ = chunk_size;
+        policy_ = policy;
+        reserve_ = reserve;
+        protected_layer_ = protected_layer;
+        reset();
+    }
+
+    // Only record geometry that can show inside `viewport` (command
+    // coordinates). Survives `reset()`; `clear_viewport()` records everything.
+    void set_viewport(const ScreenRect& viewport) noexcept {
+        viewport_ = viewport;
+        has_viewport_ = true;
+    }
+    void clear_viewport() noexcept { has_viewport_ = false; }
+    [[nodiscard]] bool has_viewport() const noexcept { return has_viewport_; }
+    [[nodiscard]] const ScreenRect& viewport() const noexcept { return viewport_; }
 
     [[nodiscard]] std::size_t capacity() const noexcept { return Capacity; }
-    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    // Encoded bytes, including overflow chunks.
+    [[nodiscard]] std::size_t size() const noexcept { return size_ + chunk_bytes_; }
+    // Commands dropped since the last reset because they did not fit.
+    [[nodiscard]] std::size_t dropped_commands() const noexcept { return dropped_; }
+    // Commands (or batch instances) rejected since the last reset for lying
+    // outside the viewport, and rects cut down to it.
+    [[nodiscard]] std::size_t culled_commands() const noexcept { return culled_; }
+    [[nodiscard]] std::size_t trimmed_commands() const noexcept { return trimmed_; }
+    // Largest `size()` any frame reached, and commands dropped over the
+    // buffer's lifetime: what to size `Capacity` (or the arena) from.
+    [[nodiscard]] std::size_t peak_size() const noexcept { return std::max(peak_size_, size()); }
+    [[nodiscard]] std::size_t total_dropped_commands() const noexcept { return dropped_total_ + dropped_; }
+    [[nodiscard]] std::size_t chunk_count() const noexcept {
+        std::size_t n = 0;
+        for (const CommandChunk* c = head_; c != nullptr; c = c->next) ++n;
+        return n;
+    }
 
-    // Push a rectangle command. Crashes if there's not enough room.
+    // Push a rectangle command.
     void push_rect(uint8_t layer, uint32_t color, int16_t x, int16_t y, int16_t w, int16_t h) noexcept {
-        // layout: opcode(1) | layer(1) | color(4) | x(2) | y(2) | w(2) | h(2)
         assert(writable_ && "attempt to write to read-only command buffer");
+        if (has_viewport_ && !trim_to_viewport(x, y, w, h)) return;
+        if (encoding_ == CommandEncoding::Compact) {
+            push_compact_rect(layer, color, x, y, w, h);
+            return;
+        }
+        // layout: opcode(1) | layer(1) | color(4) | x(2) | y(2) | w(2) | h(2)
         constexpr std::size_t needed = 1 + 1 + 4 + 2 + 2 + 2 + 2;
-        assert(size_ + needed <= Capacity);
-        uint8_t* ptr = &buf_[size_];
+        uint8_t* ptr = reserve(needed, layer);
+        if (ptr == nullptr) return;
         ptr[0] = static_cast<uint8_t>(RenderCommandType::Rect);
         ptr[1] = layer;
         std::memcpy(ptr + 2, &color, 4);
@@ -34,67 +432,252 @@ public:
         std::memcpy(ptr + 8, &y, 2);
         std::memcpy(ptr +10, &w, 2);
         std::memcpy(ptr +12, &h, 2);
-        size_ += needed;
     }
 
-    // Push a clear command. Crashes if there's not enough room.
+    // Push a clear command. Clears belong to no layer and are never dropped
+    // by OverflowPolicy::DropLowestLayer. They are ordering barriers: layer
+    // sorting never moves a command across a clear, so a clear wipes
+    // everything recorded before it regardless of layer.
     void push_clear(uint32_t color) noexcept {
         // opcode(1) | color(4)
         assert(writable_ && "attempt to write to read-only command buffer");
         constexpr std::size_t needed = 1 + 4;
-        assert(size_ + needed <= Capacity);
-        uint8_t* ptr = &buf_[size_];
+        uint8_t* ptr = reserve(needed, UINT8_MAX);
+        if (ptr == nullptr) return;
         ptr[0] = static_cast<uint8_t>(RenderCommandType::Clear);
         std::memcpy(ptr + 1, &color, 4);
-        size_ += needed;
     }
 
-    // Decode into a FrameBuffer (caller supplies target). Returns number of commands decoded.
+    // Push a sprite: `frame` of atlas `atlas` drawn unscaled with its top-left
+    // corner at (x, y). `flags` is a mask of SpriteFlags.
+    void push_sprite(uint8_t layer, uint8_t atlas, const SpriteFrame& frame, int16_t x, int16_t y,
+                     uint8_t flags = 0) noexcept {
+        // opcode(1) | layer(1) | atlas(1) | flags(1) | sx(2) | sy(2) | w(2) | h(2) | x(2) | y(2)
+        assert(writable_ && "attempt to write to read-only command buffer");
+        if (has_viewport_ && !viewport_.intersects(x, y, frame.w, frame.h)) {
+            ++culled_;
+            return;
+        }
+        constexpr std::size_t needed = 1 + 1 + 1 + 1 + 2 + 2 + 2 + 2 + 2 + 2;
+        uint8_t* ptr = reserve(needed, layer);
+        if (ptr == nullptr) return;
+        ptr[0] = static_cast<uint8_t>(RenderCommandType::Sprite);
+        ptr[1] = layer;
+        ptr[2] = atlas;
+        ptr[3] = flags;
+        std::memcpy(ptr + 4, &frame.x, 2);
+        std::memcpy(ptr + 6, &frame.y, 2);
+        std::memcpy(ptr + 8, &frame.w, 2);
+        std::memcpy(ptr +10, &frame.h, 2);
+        std::memcpy(ptr +12, &x, 2);
+        std::memcpy(ptr +14, &y, 2);
+    }
+
+    // Push `rects` as one RectBatch command sharing `layer` and `color`: an
+    // 8-byte header followed by the packed geometry (8 bytes per rect), decoded
+    // and rasterized as a unit. Spans longer than kMaxRectBatch are recorded
+    // as several consecutive batches. A batch that does not fit is dropped as
+    // a whole (one dropped command). With a viewport, instances entirely
+    // outside it are left out (each counted as culled) and a batch with none
+    // left is not recorded.
+    void push_rect_batch(uint8_t layer, uint32_t color, std::span<const RectInstance> rects) noexcept {
+        // opcode(1) | layer(1) | color(4) | count(2) | count * {x, y, w, h}(8)
+        assert(writable_ && "attempt to write to read-only command buffer");
+        if (rects.size() > kMaxRectBatch) {
+            for (std::size_t i = 0; i < rects.size(); i += kMaxRectBatch) {
+                push_rect_batch(layer, color, rects.subspan(i, std::min(kMaxRectBatch, rects.size() - i)));
+            }
+            return;
+        }
+        constexpr std::size_t header = 1 + 1 + 4 + 2;
+        std::size_t visible = rects.size();
+        if (has_viewport_) {
+            visible = 0;
+            for (const auto& r : rects) visible += viewport_.intersects(r.x, r.y, r.w, r.h) ? 1u : 0u;
+            culled_ += rects.size() - visible;
+            if (visible == 0 && !rects.empty()) return;
+        }
+        uint8_t* ptr = reserve(header + visible * sizeof(RectInstance), layer);
+        if (ptr == nullptr) return;
+        const auto count = static_cast<uint16_t>(visible);
+        ptr[0] = static_cast<uint8_t>(RenderCommandType::RectBatch);
+        ptr[1] = layer;
+        std::memcpy(ptr + 2, &color, 4);
+        std::memcpy(ptr + 6, &count, 2);
+        if (visible == rects.size()) {
+            if (count != 0) std::memcpy(ptr + header, rects.data(), rects.size_bytes());
+            return;
+        }
+        uint8_t* dst = ptr + header;
+        for (const auto& r : rects) {
+            if (!viewport_.intersects(r.x, r.y, r.w, r.h)) continue;
+            std::memcpy(dst, &r, sizeof(RectInstance));
+            dst += sizeof(RectInstance);
+        }
+    }
+
+    // Zero-copy access to the encoded commands; see CommandView.
+    [[nodiscard]] CommandView view() const noexcept { return CommandView(buf_, size_, head_, size()); }
+
+    // Visit every encoded command in record order without materialising them.
+    template<typename Visitor>
+    std::size_t for_each(Visitor&& visitor) const {
+        return view().for_each(std::forward<Visitor>(visitor));
+    }
+
+    // Decode into a FrameBuffer (caller supplies target). Returns number of
+    // commands decoded. A FrameBuffer outlives the encoded bytes, so batches
+    // are expanded into one Rect per instance.
     template<std::size_t MaxCommands>
     std::size_t decode(FrameBuffer<MaxCommands>& out) const noexcept {
         out.reset();
-        std::size_t p = 0;
-        while (p < size_) {
-            uint8_t opcode = buf_[p];
-            if (opcode == static_cast<uint8_t>(RenderCommandType::Clear)) {
-                if (p + 1 + 4 > size_) break; // malformed
-                uint32_t color;
-                std::memcpy(&color, &buf_[p + 1], 4);
-                RenderCommand rc{};
-                rc.type = RenderCommandType::Clear;
-                rc.color = color;
-                out.push(rc);
-                p += 1 + 4;
-            } else if (opcode == static_cast<uint8_t>(RenderCommandType::Rect)) {
-                constexpr std::size_t chunk = 1 + 1 + 4 + 2 + 2 + 2 + 2;
-                if (p + chunk > size_) break; // malformed
-                uint8_t layer = buf_[p + 1];
-                uint32_t color;
-                int16_t x,y,w,h;
-                std::memcpy(&color, &buf_[p + 2], 4);
-                std::memcpy(&x, &buf_[p + 6], 2);
-                std::memcpy(&y, &buf_[p + 8], 2);
-                std::memcpy(&w, &buf_[p +10], 2);
-                std::memcpy(&h, &buf_[p +12], 2);
-                RenderCommand rc{};
-                rc.type = RenderCommandType::Rect;
-                rc.layer = layer;
-                rc.color = color;
-                rc.rect = {x,y,w,h};
+        view().for_each([&out](const RenderCommand& rc) {
+            if (rc.type != RenderCommandType::RectBatch) {
                 out.push(rc);
-                p += chunk;
-            } else {
-                // unknown opcode, stop
-                break;
+                return;
             }
-        }
+            RenderCommand r{};
+            r.type = RenderCommandType::Rect;
+            r.layer = rc.layer;
+            r.color = rc.color;
+            for (std::size_t i = 0; i < rc.batch.count; ++i) {
+                const RectInstance g = rc.rect_instance(i);
+                r.rect = {g.x, g.y, g.w, g.h};
+                out.push(r);
+            }
+        });
         return out.size();
     }
 
 private:
+    // Room for a `needed`-byte command on `layer` (UINT8_MAX: no layer), in
+    // the base block, the current chunk or a new one. Returns nullptr and
+    // counts the command as dropped when it cannot be stored.
+    uint8_t* reserve(std::size_t needed, uint8_t layer) noexcept {
+        // A compact stream opens with its version tag, stored together with
+        // the first command so it lands in the same segment.
+        const std::size_t tag = (encoding_ != CommandEncoding::Fixed && size() == 0) ? 2 : 0;
+        needed += tag;
+        uint8_t* ptr = nullptr;
+        if (tail_ == nullptr && size_ + needed <= Capacity) {
+            ptr = &buf_[size_];
+            size_ += needed;
+        } else if (tail_ != nullptr && tail_->size + needed <= tail_->capacity) {
+            ptr = tail_->data() + tail_->size;
+            tail_->size += needed;
+            chunk_bytes_ += needed;
+        } else if (CommandChunk* c = new_chunk(needed, layer)) {
+            ptr = c->data();
+            c->size = needed;
+            chunk_bytes_ += needed;
+        } else {
+            ++dropped_;
+            return nullptr;
+        }
+        if (tag != 0) {
+            ptr[0] = static_cast<uint8_t>(detail::StreamOp::Version);
+            ptr[1] = static_cast<uint8_t>(encoding_);
+            ptr += tag;
+        }
+        return ptr;
+    }
+
+    // Clip a rect to the viewport. Returns false (counted as culled) when
+    // nothing is left.
+    bool trim_to_viewport(int16_t& x, int16_t& y, int16_t& w, int16_t& h) noexcept {
+        const int32_t x0 = std::max<int32_t>(x, viewport_.x);
+        const int32_t y0 = std::max<int32_t>(y, viewport_.y);
+        const int32_t x1 = std::min<int32_t>(x + w, viewport_.x + viewport_.w);
+        const int32_t y1 = std::min<int32_t>(y + h, viewport_.y + viewport_.h);
+        if (x0 >= x1 || y0 >= y1) {
+            ++culled_;
+            return false;
+        }
+        if (x0 != x || y0 != y || x1 != x + w || y1 != y + h) {
+            ++trimmed_;
+            x = static_cast<int16_t>(x0);
+            y = static_cast<int16_t>(y0);
+            w = static_cast<int16_t>(x1 - x0);
+            h = static_cast<int16_t>(y1 - y0);
+        }
+        return true;
+    }
+
+    CommandChunk* new_chunk(std::size_t needed, uint8_t layer) noexcept {
+        if (arena_ == nullptr) return nullptr;
+        const std::size_t bytes = sizeof(CommandChunk) + std::max(chunk_size_, needed);
+        if (policy_ == OverflowPolicy::DropLowestLayer && layer < protected_layer_ &&
+            arena_->used() + bytes + reserve_ > arena_->capacity()) return nullptr;
+        void* mem = arena_->allocate(bytes, alignof(CommandChunk));
+        if (mem == nullptr) return nullptr;
+        auto* c = new (mem) CommandChunk{nullptr, 0, bytes - sizeof(CommandChunk)};
+        if (tail_ != nullptr) tail_->next = c;
+        else head_ = c;
+        tail_ = c;
+        return c;
+    }
+
+    void push_compact_rect(uint8_t layer, uint32_t color, int16_t x, int16_t y, int16_t w, int16_t h) noexcept {
+        // Worst case: SetLayer(2) + SetColor(5) + rect. The encoder state only
+        // advances once the bytes are stored.
+        uint8_t tmp[2 + 5 + detail::kMaxCompactRect];
+        uint8_t* ptr = tmp;
+        if (layer != state_.layer) {
+            *ptr++ = static_cast<uint8_t>(detail::StreamOp::SetLayer);
+            *ptr++ = layer;
+        }
+        if (color != state_.color) {
+            *ptr++ = static_cast<uint8_t>(detail::StreamOp::SetColor);
+            std::memcpy(ptr, &color, 4);
+            ptr += 4;
+        }
+        *ptr++ = static_cast<uint8_t>(detail::StreamOp::CompactRect);
+        ptr = detail::put_varint(ptr, detail::zigzag(x - state_.x));
+        ptr = detail::put_varint(ptr, detail::zigzag(y - state_.y));
+        ptr = detail::put_varint(ptr, detail::zigzag(w));
+        ptr = detail::put_varint(ptr, detail::zigzag(h));
+        const auto needed = static_cast<std::size_t>(ptr - tmp);
+        uint8_t* dst = reserve(needed, layer);
+        if (dst == nullptr) return;
+        std::memcpy(dst, tmp, needed);
+        state_.layer = layer;
+        state_.color = color;
+        state_.x = x;
+        state_.y = y;
+    }
+
     uint8_t buf_[Capacity];
-    std::size_t size_ = 0;
+    std::size_t size_ = 0; // bytes in buf_
     bool writable_ = true;
+    CommandEncoding encoding_ = CommandEncoding::Fixed;
+    detail::StreamState state_{}; // encoder side of the compact stream
+    StaticArena* arena_ = nullptr;
+    std::size_t chunk_size_ = Capacity;
+    std::size_t reserve_ = 0;
+    uint8_t protected_layer_ = 1; // lowest layer allowed into the reserve
+    OverflowPolicy policy_ = OverflowPolicy::DropNewest;
+    CommandChunk* head_ = nullptr;
+    CommandChunk* tail_ = nullptr;
+    std::size_t chunk_bytes_ = 0;
+    std::size_t dropped_ = 0;
+    ScreenRect viewport_{};
+    bool has_viewport_ = false;
+    std::size_t culled_ = 0;
+    std::size_t trimmed_ = 0;
+    std::size_t peak_size_ = 0;
+    std::size_t dropped_total_ = 0;
 };
 
+// Memory report entry (see TrackedMemory). A peak above the capacity means
+// frames spilled into overflow chunks.
+template<std::size_t Capacity>
+[[nodiscard]] MemoryUsage memory_usage(const MemoryCommandBuffer<Capacity>& buf) noexcept {
+    MemoryUsage u;
+    u.block_size = Capacity;
+    u.used = buf.size();
+    u.peak = buf.peak_size();
+    u.failed = buf.total_dropped_commands();
+    return u;
+}
+
 } // namespace ege
@@ -0,0 +1,82 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+namespace ege {
+
+struct FramePacerConfig {
+    // Fixed simulation rate: `on_update`/`physics.step` always see 1/update_hz.
+    double update_hz = 60.0;
+    // Frame (record/present) rate cap; 0 runs frames back to back.
+    double target_fps = 60.0;
+    // Most fixed steps run in one frame. Time beyond that is dropped so a
+    // long stall cannot trigger a catch-up spiral.
+    int max_updates_per_frame = 5;
+    // The last stretch before a frame deadline is busy-waited instead of
+    // slept, because OS sleeps routinely overshoot by around a millisecond.
+    std::chrono::microseconds spin_threshold{1000};
+};
+
+// Frame interval statistics (time between successive `begin_frame` calls).
+struct FrameTimingStats {
+    uint64_t frames = 0;         // intervals measured
+    double last_ms = 0.0;
+    double mean_ms = 0.0;
+    double min_ms = 0.0;
+    double max_ms = 0.0;
+    double jitter_ms = 0.0;      // standard deviation of the interval
+    uint64_t dropped_steps = 0;  // fixed steps skipped by the catch-up bound
+};
+
+// Fixed-timestep frame pacer driven by a monotonic clock.
+//
+// Each frame `begin_frame(now)` adds the real elapsed time to an accumulator
+// and returns how many fixed steps to simulate; `alpha()` is the leftover
+// fraction of a step for interpolating between the last two simulated
+// states. `wait_for_next_frame()` then sleeps and spins until the next frame
+// deadline. Time is passed in explicitly so tests can drive the pacer with a
+// synthetic clock.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FramePacer(FramePacerConfig config = {}) noexcept;
+
+    [[nodiscard]] const FramePacerConfig& config() const noexcept { return config_; }
+
+    // Restart timing at `now`: empties the accumulator and clears statistics.
+    void reset(Clock::time_point now) noexcept;
+
+    // Account for the time since the previous frame and return the number of
+    // fixed steps to run, at most `max_updates_per_frame`.
+    [[nodiscard]] int begin_frame(Clock::time_point now) noexcept;
+
+    // Fixed step length in seconds.
+    [[nodiscard]] float step_seconds() const noexcept { return static_cast<float>(step_.count()); }
+
+    // Unsimulated time as a fraction of one step, in [0, 1).
+    [[nodiscard]] float alpha() const noexcept;
+
+    // Block until the next frame deadline (no-op when `target_fps` is 0).
+    void wait_for_next_frame() noexcept;
+
+    [[nodiscard]] const FrameTimingStats& stats() const noexcept { return stats_; }
+
+private:
+    using Seconds = std::chrono::duration<double>;
+
+    FramePacerConfig config_;
+    Seconds step_;
+    Clock::duration frame_period_{};
+    Clock::time_point last_frame_{};
+    Clock::time_point next_deadline_{};
+    Seconds accumulator_{0.0};
+    bool started_ = false;
+
+    FrameTimingStats stats_;
+    double m2_ = 0.0; // running sum of squared deviations (Welford)
+
+    void record_interval(double ms) noexcept;
+};
+
+} // namespace ege
@@ -0,0 +1,134 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <thread>
+#include <vector>
+
+namespace ege {
+
+// Completion counter for a group of jobs. `JobSystem::submit` increments it,
+// job completion decrements it, and `JobSystem::wait` returns once it reaches
+// zero. It doubles as a dependency: `JobSystem::submit_after` schedules a job
+// to start once another counter reaches zero, without blocking the caller.
+struct JobCounter {
+    std::atomic<uint32_t> pending{0};
+    [[nodiscard]] bool done() const noexcept { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+// Job entry point: processes items [begin, end) of whatever `data` points to.
+using JobFn = void (*)(void* data, std::size_t begin, std::size_t end);
+
+// Small fixed-size work-stealing scheduler.
+//
+// `JobSystem(n)` runs n workers: the constructing thread (worker 0, which
+// executes jobs while it `wait`s) plus n - 1 background threads. Every worker
+// owns a fixed-capacity deque of plain `{fn, data, range, counter}` records,
+// so submitting never allocates. Owners push and pop at the back (LIFO, warm
+// caches); idle workers steal from the front of other deques. When a deque is
+// full the job runs inline on the submitting thread instead.
+//
+// Threads that are not workers may submit too; their jobs go to worker 0's
+// deque.
+class JobSystem {
+public:
+    static constexpr std::size_t kQueueCapacity = 256;
+    // Jobs that can be parked waiting on a dependency at once.
+    static constexpr std::size_t kDeferredCapacity = 256;
+
+    // `workers` == 0 uses std::thread::hardware_concurrency().
+    explicit JobSystem(std::size_t workers = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    [[nodiscard]] std::size_t worker_count() const noexcept { return queues_.size(); }
+
+    void submit(JobFn fn, void* data, std::size_t begin, std::size_t end, JobCounter& counter);
+
+    // Like `submit`, but the job only becomes runnable once `dependency`
+    // reaches zero (immediately if it already has). `counter` counts the job
+    // from now on, so waiting on it covers the parked job too. `dependency`
+    // must stay alive until its pending jobs finish. If every deferred slot
+    // is taken, the caller waits for `dependency` and then submits.
+    void submit_after(JobCounter& dependency, JobFn fn, void* data, std::size_t begin, std::size_t end,
+                      JobCounter& counter);
+
+    // Run queued jobs on the calling thread until `counter` reaches zero.
+    void wait(JobCounter& counter) noexcept;
+
+    // Call `fn(i)` for every i in [0, count), split into chunks of at least
+    // `grain` items across the workers, and return when all calls finished.
+    template<typename Fn>
+    void parallel_for(std::size_t count, Fn&& fn, std::size_t grain = 1) {
+        if (count == 0) return;
+        const std::size_t target_chunks = worker_count() * 4;
+        std::size_t chunk = (count + target_chunks - 1) / target_chunks;
+        if (chunk < grain) chunk = grain;
+        JobCounter counter;
+        using F = std::remove_reference_t<Fn>;
+        for (std::size_t begin = 0; begin < count; begin += chunk) {
+            const std::size_t end = (count - begin > chunk) ? begin + chunk : count;
+            submit([](void* data, std::size_t b, std::size_t e) {
+                F& f = *static_cast<F*>(data);
+                for (std::size_t i = b; i < e; ++i) f(i);
+            }, const_cast<void*>(static_cast<const void*>(&fn)), begin, end, counter);
+        }
+        wait(counter);
+    }
+
+    // Jobs taken from another worker's deque since construction.
+    [[nodiscard]] uint64_t steal_count() const noexcept { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct Job {
+        JobFn fn = nullptr;
+        void* data = nullptr;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        JobCounter* counter = nullptr;
+    };
+
+    // A parked job and the counter it waits for; `dependency == nullptr`
+    // marks a free slot.
+    struct Deferred {
+        Job job;
+        JobCounter* dependency = nullptr;
+    };
+
+    // Fixed ring; the owner uses the back, thieves the front.
+    struct WorkQueue {
+        std::mutex mutex;
+        std::array<Job, kQueueCapacity> jobs{};
+        std::size_t front = 0;
+        std::size_t size = 0;
+
+        bool push_back(const Job& j) noexcept;
+        bool pop_back(Job& out) noexcept;
+        bool pop_front(Job& out) noexcept;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> running_{true};
+    // Bumped on every submit so sleeping workers wake up.
+    std::atomic<uint32_t> work_epoch_{0};
+    std::atomic<uint64_t> steals_{0};
+    std::mutex deferred_mutex_;
+    std::array<Deferred, kDeferredCapacity> deferred_{};
+    std::atomic<uint32_t> deferred_count_{0};
+
+    void worker_main(std::size_t index);
+    std::size_t current_worker() const noexcept;
+    bool run_one(std::size_t self) noexcept;
+    void execute(const Job& job) noexcept;
+    void enqueue(const Job& job) noexcept;
+    void release_deferred() noexcept;
+};
+
+} // namespace ege
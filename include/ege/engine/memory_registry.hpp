@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ege {
+
+// Usage of one fixed-size memory region, for sizing static allocations.
+// Regions made of `blocks` equal blocks (e.g. a pipeline's command buffers)
+// report `used`/`peak` of their fullest block, since that is what decides
+// whether `block_size` can shrink.
+struct MemoryUsage {
+    std::size_t block_size = 0;
+    std::size_t blocks = 1;
+    std::size_t used = 0;
+    std::size_t peak = 0;              // high-watermark of `used`, survives resets
+    uint64_t allocations = 0;          // successful allocations (arenas)
+    uint64_t failed = 0;               // failed allocations / dropped commands
+    std::size_t wasted_alignment = 0;  // padding bytes inserted for alignment
+    bool canary_ok = true;             // debug fill intact (arenas with a canary)
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return block_size * blocks; }
+};
+
+// Intrusive entry of the global memory registry. The owner keeps it alive
+// while registered; `usage(owner)` is called whenever a report is made.
+struct MemoryEntry {
+    const char* name = nullptr; // static storage (a string literal)
+    const void* owner = nullptr;
+    MemoryUsage (*usage)(const void* owner) = nullptr;
+    MemoryEntry* prev = nullptr;
+    MemoryEntry* next = nullptr;
+};
+
+// Process-wide list of named regions. Registration takes a lock and is meant
+// for set-up and tear-down; reports read live counters without stopping
+// other threads, so take them between frames for exact numbers.
+namespace memory {
+
+void register_entry(MemoryEntry& entry) noexcept;
+void unregister_entry(MemoryEntry& entry) noexcept;
+
+// Call `fn(name, usage)` for every registered region, in registration order.
+void for_each(void (*fn)(const char* name, const MemoryUsage& usage, void* ctx), void* ctx);
+
+template<typename Fn>
+void for_each(Fn&& fn) {
+    for_each([](const char* name, const MemoryUsage& usage, void* ctx) { (*static_cast<Fn*>(ctx))(name, usage); },
+             &fn);
+}
+
+// One line per region: name, capacity, used, peak (and % of capacity),
+// allocations, failures, alignment waste and canary state.
+[[nodiscard]] std::string report();
+
+} // namespace memory
+
+// Registers any object with a `memory_usage(const T&)` overload (command
+// buffers, render pipelines) under `name` for as long as it lives.
+template<typename T>
+class TrackedMemory {
+public:
+    TrackedMemory(const char* name, const T& object) noexcept {
+        entry_.name = name;
+        entry_.owner = &object;
+        entry_.usage = [](const void* owner) { return memory_usage(*static_cast<const T*>(owner)); };
+        memory::register_entry(entry_);
+    }
+    ~TrackedMemory() { memory::unregister_entry(entry_); }
+    TrackedMemory(const TrackedMemory&) = delete;
+    TrackedMemory& operator=(const TrackedMemory&) = delete;
+
+private:
+    MemoryEntry entry_;
+};
+
+} // namespace ege
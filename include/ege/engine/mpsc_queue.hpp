@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <ege/engine/spsc_queue.hpp>
+
+namespace ege {
+
+// Bounded multi-producer single-consumer queue (Vyukov-style sequence ring).
+// Holds up to `Capacity` elements and never allocates.
+//
+// Every slot carries a sequence number that says whose turn it is: a slot at
+// ring position `pos` is free for the producer claiming `pos` when
+// `seq == pos`, and holds a value for the consumer when `seq == pos + 1`.
+// Producers claim positions with a CAS on the shared enqueue index, then
+// publish the slot with a release store of its sequence. They only contend on
+// that one index, never on a lock. The single consumer owns the dequeue
+// index outright.
+template<typename T, std::size_t Capacity>
+class MPSCQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be power of two");
+    static constexpr std::size_t kMask = Capacity - 1;
+public:
+    MPSCQueue() noexcept {
+        for (std::size_t i = 0; i < Capacity; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    // Safe to call from any number of threads. Returns false when full.
+    [[nodiscard]] bool push(const T& v) noexcept {
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & kMask];
+            const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // the consumer has not freed this slot yet: full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed); // lost a race; retry
+            }
+        }
+        cell->value = v;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Returns false when empty, or when the oldest claimed
+    // slot is still being written by its producer.
+    [[nodiscard]] bool pop(T& out) noexcept {
+        Cell& cell = cells_[dequeue_pos_ & kMask];
+        if (cell.seq.load(std::memory_order_acquire) != dequeue_pos_ + 1) return false;
+        out = cell.value;
+        cell.seq.store(dequeue_pos_ + Capacity, std::memory_order_release);
+        ++dequeue_pos_;
+        return true;
+    }
+
+    // Consumer only. Pop up to `out.size()` elements in order; returns the
+    // number written.
+    [[nodiscard]] std::size_t pop_n(std::span<T> out) noexcept {
+        std::size_t n = 0;
+        while (n < out.size() && pop(out[n])) ++n;
+        return n;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> seq;
+        T value;
+    };
+
+    alignas(kCacheLineSize) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(kCacheLineSize) std::size_t dequeue_pos_ = 0;
+    alignas(kCacheLineSize) Cell cells_[Capacity];
+};
+
+} // namespace ege
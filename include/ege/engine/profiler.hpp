@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Scoped frame-phase instrumentation.
+//
+//   void Game::on_update(float dt) {
+//       EGE_PROFILE_SCOPE("game.ai");
+//       ...
+//   }
+//
+// Each thread records into its own fixed-size ring of the most recent
+// samples, so recording takes no lock and never allocates after a thread's
+// first sample. The rings can be exported as Chrome `trace_event` JSON
+// (chrome://tracing, Perfetto) or summarized per phase.
+//
+// The macros compile to nothing unless EGE_PROFILE_ENABLED is defined to 1
+// (CMake: -DEGE_PROFILE=ON). The functions below are always available, so
+// tools can call `summary()` unconditionally; it is simply empty.
+namespace ege::profile {
+
+// Ring slots per thread; older samples are overwritten. Readers see the
+// newest kRingCapacity - 1 (the next slot may be mid-write).
+inline constexpr std::size_t kRingCapacity = 4096;
+
+// Nanoseconds on the steady clock since the profiler's epoch (first use).
+[[nodiscard]] uint64_t now_ns() noexcept;
+
+// Record a finished phase for the calling thread. `name` must have static
+// storage duration (a string literal); only the pointer is stored. The
+// thread's ring (about 96 KB) is allocated on its first sample; if that
+// fails, the thread's samples are dropped and counted in `dropped_samples()`.
+void record(const char* name, uint64_t start_ns, uint64_t end_ns) noexcept;
+
+// Allocate the calling thread's ring now, e.g. at thread start-up while the
+// heap is still roomy. Returns false if the allocation failed.
+bool prepare_thread() noexcept;
+
+// Label the calling thread in exported traces (static storage, like names).
+void set_thread_name(const char* name) noexcept;
+
+// Samples dropped because a thread's ring could not be allocated.
+[[nodiscard]] uint64_t dropped_samples() noexcept;
+
+class Scope {
+public:
+    explicit Scope(const char* name) noexcept : name_(name), start_(now_ns()) {}
+    ~Scope() { record(name_, start_, now_ns()); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_;
+};
+
+// Rolling statistics of one phase over the samples still held in the rings.
+struct PhaseStats {
+    const char* name = nullptr;
+    uint64_t count = 0;
+    double min_us = 0.0;
+    double avg_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+};
+
+// Per-phase statistics across all threads, sorted by name.
+[[nodiscard]] std::vector<PhaseStats> summary();
+// Chrome trace_event JSON ("X" complete events plus thread names).
+[[nodiscard]] std::string chrome_trace_json();
+bool write_chrome_trace(const char* path);
+// Forget every sample recorded so far (rings stay allocated).
+void clear() noexcept;
+
+} // namespace ege::profile
+
+#if defined(EGE_PROFILE_ENABLED) && EGE_PROFILE_ENABLED
+#define EGE_PROFILE_CONCAT_INNER(a, b) a##b
+#define EGE_PROFILE_CONCAT(a, b) EGE_PROFILE_CONCAT_INNER(a, b)
+#define EGE_PROFILE_SCOPE(name) \
+    const ::ege::profile::Scope EGE_PROFILE_CONCAT(ege_profile_scope_, __LINE__)(name)
+#define EGE_PROFILE_THREAD(name) ::ege::profile::set_thread_name(name)
+#else
+#define EGE_PROFILE_SCOPE(name) static_cast<void>(0)
+#define EGE_PROFILE_THREAD(name) static_cast<void>(0)
+#endif
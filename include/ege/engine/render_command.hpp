@@ -1,7 +1,8 @@
 #pragma once
 #include <cstdint>
+#include <cstddef>
+#include <cstring>
 #include <array>
-#include <cassert>
 
 namespace ege {
 
@@ -9,6 +10,27 @@ enum class RenderCommandType : uint8_t {
     Clear = 0,
     Rect,
     Sprite,
+    RectBatch,
+};
+
+// Axis-aligned rectangle in command (screen) coordinates, half-open, used for
+// viewports and layer bounds.
+struct ScreenRect {
+    int32_t x = 0, y = 0;
+    int32_t w = 0, h = 0;
+
+    [[nodiscard]] constexpr bool intersects(int32_t ox, int32_t oy, int32_t ow, int32_t oh) const noexcept {
+        return ox < x + w && x < ox + ow && oy < y + h && y < oy + oh && ow > 0 && oh > 0;
+    }
+    [[nodiscard]] constexpr bool intersects(const ScreenRect& o) const noexcept {
+        return intersects(o.x, o.y, o.w, o.h);
+    }
+};
+
+// Geometry of one rect in a RectBatch.
+struct RectInstance {
+    int16_t x, y;
+    int16_t w, h;
 };
 
 struct RenderCommand {
@@ -18,21 +40,43 @@ struct RenderCommand {
     struct {
         int16_t x, y;
         int16_t w, h;
-    } rect;
-    // sprite metadata could be added later
+    } rect; // for sprites: destination position and frame size
+    struct {
+        uint8_t atlas;  // atlas id registered with the backend
+        uint8_t flags;  // SpriteFlags
+        int16_t sx, sy; // frame origin inside the atlas
+    } sprite;
+    struct {
+        // Packed RectInstance array inside the encoded stream; valid only
+        // while the bytes the command was decoded from are.
+        const uint8_t* data;
+        uint16_t count;
+    } batch; // RectBatch: `count` rects sharing layer and colour
+
+    [[nodiscard]] RectInstance rect_instance(std::size_t i) const noexcept {
+        RectInstance r;
+        std::memcpy(&r, batch.data + i * sizeof(RectInstance), sizeof(RectInstance));
+        return r;
+    }
 };
 
 template<std::size_t MaxCommands>
 struct FrameBuffer {
     std::array<RenderCommand, MaxCommands> commands{};
     std::size_t count = 0;
+    std::size_t dropped = 0; // pushes rejected since reset because the buffer was full
 
-    void push(const RenderCommand& cmd) noexcept {
-        assert (count < MaxCommands);
+    // Returns false (and counts the command in `dropped`) when full.
+    bool push(const RenderCommand& cmd) noexcept {
+        if (count >= MaxCommands) {
+            ++dropped;
+            return false;
+        }
         commands[count++] = cmd;
+        return true;
     }
 
-    void reset() noexcept { count = 0; }
+    void reset() noexcept { count = 0; dropped = 0; }
     [[nodiscard]] std::size_t size() const noexcept { return count; }
 };
 
@@ -2,7 +2,10 @@
 #include "spsc_queue.hpp"
 #include "render_command.hpp"
 #include "command_buffer.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <concepts>
 #include <cstdint>
 #include <optional>
 #include <functional>
@@ -91,6 +94,17 @@ public:
         return true;
     }
 
+    // Set-up only (before frames are in flight): call `fn(index, CmdBuf&)`
+    // for every buffer, e.g. to give each its own overflow arena.
+    template<typename Fn>
+    void for_each_buffer(Fn&& fn) noexcept {
+        for (std::size_t i = 0; i < BufferCount; ++i) fn(i, buffers_[i]);
+    }
+    template<typename Fn>
+    void for_each_buffer(Fn&& fn) const noexcept {
+        for (std::size_t i = 0; i < BufferCount; ++i) fn(i, buffers_[i]);
+    }
+
 private:
     CmdBuf buffers_[BufferCount];
     CmdBuf empty_buf_{false};
@@ -99,4 +113,145 @@ private:
     uint32_t current_write_idx_ = UINT32_MAX;
 };
 
+// Lock-free latest-frame mailbox: a triple buffer handed between exactly one
+// producer and one consumer through a single atomic index exchange.
+//
+// The producer always owns one back buffer, the consumer owns one front
+// buffer and the third sits in the mailbox. `submit_frame()` swaps the back
+// buffer into the mailbox (marking it fresh) and takes back whatever was
+// there, so recording never blocks or gets skipped; an unconsumed frame is
+// simply overwritten. `try_consume()` swaps the front buffer into the mailbox
+// only when it holds a fresh frame, so the consumer always receives the most
+// recent completed frame and never sees stale ones. Use this instead of
+// `SPSCRenderPipeline` when input-to-photon latency matters more than
+// presenting every frame.
+//
+// The API mirrors `SPSCRenderPipeline`. A consumed buffer stays owned by the
+// consumer until its next successful `try_consume()`; `release_buffer()`
+// only ends the caller's use of it.
+template<std::size_t CmdCapacity>
+class MailboxRenderPipeline {
+public:
+    using CmdBuf = MemoryCommandBuffer<CmdCapacity>;
+    using Frame = FrameBuffer<256>;
+    using OptionalCmdBufRef = std::optional<std::reference_wrapper<CmdBuf>>;
+
+    // `try_consume` already hands out only the newest frame, so consumers
+    // take one frame per present instead of draining.
+    static constexpr bool kConsumesLatest = true;
+
+    MailboxRenderPipeline() noexcept = default;
+
+    // Producer: the back buffer is always available.
+    [[nodiscard]] OptionalCmdBufRef begin_frame() noexcept {
+        buffers_[back_].reset();
+        recording_ = true;
+        return OptionalCmdBufRef{std::ref(buffers_[back_])};
+    }
+
+    // Publish the back buffer as the newest frame and take the mailbox slot
+    // as the next back buffer.
+    void submit_frame() noexcept {
+        if (!recording_) return;
+        recording_ = false;
+        const uint32_t prev = mailbox_.exchange(back_ | kFresh, std::memory_order_acq_rel);
+        if (prev & kFresh) overwritten_.fetch_add(1, std::memory_order_relaxed);
+        back_ = prev & kIndexMask;
+    }
+
+    [[nodiscard]] OptionalCmdBufRef current_cmdbuf_ref() noexcept {
+        if (!recording_) return std::nullopt;
+        return OptionalCmdBufRef{std::ref(buffers_[back_])};
+    }
+
+    bool idx_is_valid(uint32_t idx) const noexcept { return idx < kBufferCount; }
+    bool idx_sentinel(uint32_t idx) const noexcept { return idx == UINT32_MAX; }
+
+    // Consumer: take the newest frame if one was submitted since the last
+    // call; otherwise sets out_idx to UINT32_MAX and returns an empty buffer.
+    [[nodiscard]] const CmdBuf& try_consume(uint32_t &out_idx) noexcept {
+        if (!(mailbox_.load(std::memory_order_relaxed) & kFresh)) {
+            out_idx = UINT32_MAX;
+            return empty_buf_;
+        }
+        const uint32_t prev = mailbox_.exchange(front_, std::memory_order_acq_rel);
+        front_ = prev & kIndexMask;
+        out_idx = front_;
+        return buffers_[front_];
+    }
+
+    // Returns false for an index that is no longer the front buffer (a later
+    // `try_consume` already took it back); nothing needs releasing then.
+    [[nodiscard]] bool release_buffer(uint32_t idx) noexcept {
+        if (idx_sentinel(idx)) return false;
+        return idx == front_;
+    }
+
+    [[nodiscard]] bool consume_and_decode(Frame& target) noexcept {
+        uint32_t idx{};
+        const CmdBuf& b = try_consume(idx);
+        if (idx_sentinel(idx)) return false;
+        b.decode(target);
+        (void)release_buffer(idx);
+        return true;
+    }
+
+    // Set-up only (before frames are in flight): call `fn(index, CmdBuf&)`
+    // for every buffer, e.g. to give each its own overflow arena.
+    template<typename Fn>
+    void for_each_buffer(Fn&& fn) noexcept {
+        for (std::size_t i = 0; i < kBufferCount; ++i) fn(i, buffers_[i]);
+    }
+    template<typename Fn>
+    void for_each_buffer(Fn&& fn) const noexcept {
+        for (std::size_t i = 0; i < kBufferCount; ++i) fn(i, buffers_[i]);
+    }
+
+    // Frames that were replaced in the mailbox before the consumer took them.
+    [[nodiscard]] uint64_t overwritten_frames() const noexcept {
+        return overwritten_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint32_t kBufferCount = 3;
+    static constexpr uint32_t kIndexMask = 0x3u;
+    static constexpr uint32_t kFresh = 0x4u;
+
+    CmdBuf buffers_[kBufferCount];
+    CmdBuf empty_buf_{false};
+    uint32_t back_ = 0;  // producer-owned
+    uint32_t front_ = 1; // consumer-owned
+    std::atomic<uint32_t> mailbox_{2};
+    std::atomic<uint64_t> overwritten_{0};
+    bool recording_ = false;
+};
+
+// Memory report entry for a pipeline (see TrackedMemory): one block per
+// command buffer, with used/peak of the fullest one.
+template<typename Pipeline>
+    requires requires { typename Pipeline::CmdBuf; }
+[[nodiscard]] MemoryUsage memory_usage(const Pipeline& pipeline) noexcept {
+    MemoryUsage u;
+    u.blocks = 0;
+    pipeline.for_each_buffer([&u](std::size_t, const typename Pipeline::CmdBuf& buf) {
+        const MemoryUsage b = memory_usage(buf);
+        u.block_size = b.block_size;
+        ++u.blocks;
+        u.used = std::max(u.used, b.used);
+        u.peak = std::max(u.peak, b.peak);
+        u.failed += b.failed;
+    });
+    return u;
+}
+
+// Operations `Runtime` needs from a render pipeline.
+template<typename P>
+concept RenderPipelineConcept = requires(P p, uint32_t idx) {
+    typename P::CmdBuf;
+    { p.begin_frame() } -> std::same_as<std::optional<std::reference_wrapper<typename P::CmdBuf>>>;
+    { p.submit_frame() } -> std::same_as<void>;
+    { p.try_consume(idx) } -> std::same_as<const typename P::CmdBuf&>;
+    { p.release_buffer(idx) } -> std::convertible_to<bool>;
+};
+
 } // namespace ege
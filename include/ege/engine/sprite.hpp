@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace ege {
+
+// Flip flags carried by sprite commands.
+enum SpriteFlags : uint8_t {
+    SpriteFlipX = 1u << 0,
+    SpriteFlipY = 1u << 1,
+};
+
+// Source rectangle of one sprite frame inside an atlas (pixels).
+struct SpriteFrame {
+    int16_t x = 0, y = 0;
+    int16_t w = 0, h = 0;
+};
+
+// A sprite sheet in ARGB8888 (0xAARRGGBB) and/or 8-bit palette indices. ARGB
+// targets draw `pixels`, indexed targets draw `indices`; both share `width`,
+// `height` and `pitch`. The atlas does not own its pixels; they usually live
+// in flash/rodata or a static array and must stay valid while the atlas is
+// registered with a backend. Pixels equal to `color_key` (indices equal to
+// its low byte) are transparent when `use_color_key` is set; every other
+// pixel is drawn opaque. Bump `version` after changing the pixels in place
+// (animated or streamed sheets) so incremental renders redraw the sprites.
+struct SpriteAtlas {
+    const uint32_t* pixels = nullptr;
+    uint16_t width = 0;
+    uint16_t height = 0;
+    std::size_t pitch = 0; // in pixels
+    uint32_t color_key = 0;
+    bool use_color_key = false;
+    const uint8_t* indices = nullptr; // indexed-mode sheet, same layout as `pixels`
+    uint32_t version = 0;             // content revision, see above
+
+    [[nodiscard]] bool contains(const SpriteFrame& f) const noexcept {
+        return (pixels != nullptr || indices != nullptr) && f.w > 0 && f.h > 0 && f.x >= 0 && f.y >= 0 &&
+               f.x + f.w <= width && f.y + f.h <= height;
+    }
+};
+
+} // namespace ege
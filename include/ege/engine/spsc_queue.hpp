@@ -1,21 +1,41 @@
 #pragma once
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <type_traits>
 #include <cassert>
+#include <span>
 
 namespace ege {
 
+// Size used to keep data written by different threads on separate cache
+// lines. Fixed rather than std::hardware_destructive_interference_size, whose
+// value may differ between translation units built with different flags.
+inline constexpr std::size_t kCacheLineSize = 64;
+
+// Bounded single-producer single-consumer ring buffer. Holds up to
+// `Capacity - 1` elements.
+//
+// The producer-owned index (`head_`) and the consumer-owned index (`tail_`)
+// live on separate cache lines, each next to a cached copy of the other
+// side's index. An operation only reloads the remote index (an acquire load
+// that pulls the other core's cache line) when the cached copy says the queue
+// looks full or empty. `push_n`/`pop_n` move a whole batch with a single
+// index publish.
 template<typename T, std::size_t Capacity>
 class SPSCQueue {
     static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be power of two");
+    static constexpr std::size_t kMask = Capacity - 1;
 public:
     SPSCQueue() noexcept : head_(0), tail_(0) {}
 
     [[nodiscard]] bool push(const T& v) noexcept {
         const std::size_t head = head_.load(std::memory_order_relaxed);
-        const std::size_t next = (head + 1) & (Capacity - 1);
-        if (next == tail_.load(std::memory_order_acquire)) return false; // full
+        const std::size_t next = (head + 1) & kMask;
+        if (next == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (next == cached_tail_) return false; // full
+        }
         buffer_[head] = v;
         head_.store(next, std::memory_order_release);
         return true;
@@ -23,18 +43,59 @@ public:
 
     [[nodiscard]] bool pop(T& out) noexcept {
         const std::size_t tail = tail_.load(std::memory_order_relaxed);
-        const std::size_t last = (tail + 1) & (Capacity - 1);
-
-        if (tail == head_.load(std::memory_order_acquire)) return false; // empty
+        if (tail == cached_head_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail == cached_head_) return false; // empty
+        }
         out = buffer_[tail];
-        tail_.store(last, std::memory_order_release);
+        tail_.store((tail + 1) & kMask, std::memory_order_release);
         return true;
     }
 
+    // Push as many leading elements of `in` as fit, in order, with a single
+    // index publish. Returns the number of elements pushed.
+    [[nodiscard]] std::size_t push_n(std::span<const T> in) noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        std::size_t free = (cached_tail_ - head - 1) & kMask;
+        if (free < in.size()) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            free = (cached_tail_ - head - 1) & kMask;
+        }
+        const std::size_t n = std::min(free, in.size());
+        if (n == 0) return 0;
+        const std::size_t first = std::min(n, Capacity - head);
+        std::copy_n(in.begin(), first, buffer_ + head);
+        std::copy_n(in.begin() + static_cast<std::ptrdiff_t>(first), n - first, buffer_);
+        head_.store((head + n) & kMask, std::memory_order_release);
+        return n;
+    }
+
+    // Pop up to `out.size()` elements in FIFO order with a single index
+    // publish. Returns the number of elements written to `out`.
+    [[nodiscard]] std::size_t pop_n(std::span<T> out) noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        std::size_t available = (cached_head_ - tail) & kMask;
+        if (available < out.size()) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            available = (cached_head_ - tail) & kMask;
+        }
+        const std::size_t n = std::min(available, out.size());
+        if (n == 0) return 0;
+        const std::size_t first = std::min(n, Capacity - tail);
+        std::copy_n(buffer_ + tail, first, out.begin());
+        std::copy_n(buffer_, n - first, out.begin() + static_cast<std::ptrdiff_t>(first));
+        tail_.store((tail + n) & kMask, std::memory_order_release);
+        return n;
+    }
+
 private:
-    T buffer_[Capacity];
-    std::atomic<std::size_t> head_;
-    std::atomic<std::size_t> tail_;
+    // Producer side: written by push, read by the consumer.
+    alignas(kCacheLineSize) std::atomic<std::size_t> head_;
+    std::size_t cached_tail_ = 0;
+    // Consumer side: written by pop, read by the producer.
+    alignas(kCacheLineSize) std::atomic<std::size_t> tail_;
+    std::size_t cached_head_ = 0;
+    alignas(kCacheLineSize) T buffer_[Capacity];
 };
 
 } // namespace ege
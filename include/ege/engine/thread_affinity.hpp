@@ -0,0 +1,11 @@
+#pragma once
+
+namespace ege {
+
+// Pin the calling thread to a single CPU core. Returns false when the core is
+// invalid or the platform offers no affinity control (currently only Linux is
+// supported; on ESP-IDF configure the core through `esp_pthread_set_cfg`
+// before the thread is created instead).
+[[nodiscard]] bool pin_current_thread(int core) noexcept;
+
+} // namespace ege
@@ -1,11 +1,21 @@
 #pragma once
+#include <array>
 #include <vector>
+#include <cstddef>
 #include <cstdint>
-#include <chrono>
+#include <span>
+#include <cassert>
+#include <atomic>
 #include <thread>
+#include <type_traits>
 #include <ege/engine/render_command.hpp>
 #include <ege/engine/render_pipeline.hpp>
 #include <ege/engine/event.hpp>
+#include <ege/engine/frame_pacer.hpp>
+#include <ege/engine/job_system.hpp>
+#include <ege/engine/mpsc_queue.hpp>
+#include <ege/engine/profiler.hpp>
+#include <ege/engine/thread_affinity.hpp>
 #include <ege/backend.hpp>
 #include <ege/physics.hpp>
 
@@ -22,19 +32,23 @@ namespace ege {
 // the layer is visible (unless `is_visible()` is false) so layers may omit
 // their own visibility guards if desired.
 struct Layer {
+    // Command buffer type every runtime pipeline records into.
+    using CmdBuf = ege::MemoryCommandBuffer<1024>;
+
     virtual ~Layer() = default;
 
     // return true if event was consumed
     virtual bool on_event(const Event &e) { (void)e; return false; }
 
-    // update logic (dt seconds)
+    // update logic (dt seconds). Called zero or more times per frame with
+    // the runtime's fixed step, see `FramePacer`.
     virtual void on_update(float dt) { (void)dt; }
 
     // called when runtime is shutting down; layers should release resources here
     virtual void on_exit() noexcept { }
 
     // Render entry point for layers. The runtime will bind a valid
-    // `ege::SPSCRenderPipeline<...>::CmdBuf*` into `cmdbuf_` before calling
+    // `ege::Layer::CmdBuf*` into `cmdbuf_` before calling
     // `on_render(frame_count)` and will unbind it afterwards. Layers should
     // push commands into `cmdbuf_` (for example: `cmdbuf_->push_rect(...)`).
     // The signature intentionally hides pipeline details so user code only
@@ -43,8 +57,9 @@ struct Layer {
 
     // Runtime-internal helpers to bind/unbind the active command buffer.
     // These are called by `Runtime` and should not be used by client code.
-    void _bind_cmdbuf(ege::SPSCRenderPipeline<1024,4,8>::CmdBuf* b) noexcept { cmdbuf_ = b; }
+    void _bind_cmdbuf(CmdBuf* b) noexcept { cmdbuf_ = b; }
     void _unbind_cmdbuf() noexcept { cmdbuf_ = nullptr; }
+    void _set_interpolation_alpha(float a) noexcept { alpha_ = a; }
 
     // Visibility helpers layers can use; runtime consults `is_visible()` to
     // decide whether to call `on_render` for a given layer.
@@ -52,111 +67,369 @@ struct Layer {
     void show() { visible_ = true; }
     void hide() { visible_ = false; }
 
+    // Opt in to running `on_update` as a job, concurrently with other such
+    // layers and with the sequential ones, when the runtime has a
+    // `JobSystem`. Only enable it for layers whose update touches no state
+    // shared with other layers.
+    void set_parallel_update(bool enabled) noexcept { parallel_update_ = enabled; }
+    bool parallel_update() const noexcept { return parallel_update_; }
+
+    // Optional screen-space bounding rect of everything the layer draws. When
+    // the runtime has a viewport (`Runtime::set_viewport`) and the bounds do
+    // not intersect it, `on_render` is skipped for the frame.
+    void set_bounds(const ScreenRect& bounds) noexcept { bounds_ = bounds; has_bounds_ = true; }
+    void clear_bounds() noexcept { has_bounds_ = false; }
+    bool has_bounds() const noexcept { return has_bounds_; }
+    const ScreenRect& bounds() const noexcept { return bounds_; }
+
+    // Fraction of a fixed step elapsed since the last `on_update`, in [0, 1).
+    // Layers can blend previous and current state by this amount in
+    // `on_render` for smooth motion when frame and update rates differ.
+    float interpolation_alpha() const noexcept { return alpha_; }
+
 protected:
     // Layers may use this protected pointer when recording commands. It is
     // non-owning and only valid during the `on_render` call invoked by the
     // runtime.
-    ege::SPSCRenderPipeline<1024,4,8>::CmdBuf* cmdbuf_ = nullptr;
+    CmdBuf* cmdbuf_ = nullptr;
     bool visible_ = false;
+    float alpha_ = 0.0f;
+    bool parallel_update_ = false;
+    ScreenRect bounds_{};
+    bool has_bounds_ = false;
+};
+
+// Record-time culling counters, summed over all frames (see
+// `Runtime::set_viewport`).
+struct CullStats {
+    uint64_t culled_layers = 0;    // on_render calls skipped: layer bounds off-screen
+    uint64_t culled_commands = 0;  // commands/batch instances rejected by the viewport
+    uint64_t trimmed_commands = 0; // rects cut down to the viewport
+};
+
+// How `Runtime::run` distributes work across threads.
+enum class ThreadingMode : uint8_t {
+    // Record, decode and present on the thread that calls `run()`.
+    SingleThreaded = 0,
+    // The thread calling `run()` only polls, updates and records; a dedicated
+    // render thread owns `try_consume`/`decode`/`backend.present`, so
+    // simulation of frame N+1 overlaps rasterization of frame N.
+    Threaded,
+};
 
+struct RuntimeConfig {
+    ThreadingMode threading = ThreadingMode::SingleThreaded;
+    // Core to pin the simulation thread (the caller of `run()`) and the
+    // render thread to; -1 leaves scheduling to the OS. See `pin_current_thread`.
+    int sim_core = -1;
+    int render_core = -1;
+    // Fixed update rate, frame-rate cap and catch-up bound.
+    FramePacerConfig pacing{};
+    // Optional scheduler for layers that opted in with `set_parallel_update`
+    // (and for physics, see `parallel_physics`). Not owned; must outlive the
+    // runtime. Without one every update runs on the simulation thread.
+    JobSystem* jobs = nullptr;
+    // Step physics with `PhysicsSystem::step_parallel` on `jobs`. Off by
+    // default: the parallel solver always uses the spatial hash and its
+    // results are not bit-identical to `step`, so enabling a job system
+    // alone never changes the simulation.
+    bool parallel_physics = false;
+    // Encoding layers record in. Compact fits roughly twice as many rects
+    // into the pipeline's fixed-size command buffers.
+    CommandEncoding command_encoding = CommandEncoding::Fixed;
 };
 
-// Simple runtime that drives backend, events and layers. Not thread-safe.
+// Simple runtime that drives backend, events and layers. The layer list is
+// not thread-safe; `stop()` may be called from any thread. In
+// `ThreadingMode::Threaded` the backend's `present` is called from the render
+// thread while `poll_input` stays on the simulation thread, so the backend
+// must tolerate that split.
+//
+// `Pipeline` selects how recorded frames reach the consumer: the default
+// `SPSCRenderPipeline` queues every frame, `MailboxRenderPipeline` always
+// hands over only the newest one. `Backend` is any type providing
+// `poll_input(std::span<Event>)` and `present(const CommandView&)`. Both
+// types are deduced from the constructor.
+//
+// A steady-state frame performs no heap allocation: input is collected into
+// a fixed per-frame event buffer and frames are recorded into the pipeline's
+// preallocated command buffers.
+template<typename Backend, typename Pipeline = ege::SPSCRenderPipeline<1024,4,8>>
+    requires RenderPipelineConcept<Pipeline>
 struct Runtime {
-    Runtime(backend::Backend& backend, ege::SPSCRenderPipeline<1024,4,8>& pipeline, PhysicsSystem &physics) noexcept
-        : backend_(backend), pipeline_(pipeline), running_(false), physics_(physics) {}
+    static_assert(std::is_same_v<typename Pipeline::CmdBuf, Layer::CmdBuf>,
+                  "pipeline must record into Layer::CmdBuf");
+
+    // Most events dispatched per frame; the rest stay queued in the backend
+    // and are delivered on the following frames.
+    static constexpr std::size_t kMaxEventsPerFrame = 256;
+    // Capacity of the queue behind `post_event`.
+    static constexpr std::size_t kPostedEventCapacity = 256;
+
+    Runtime(Backend& backend, Pipeline& pipeline, PhysicsSystem &physics,
+            RuntimeConfig config = {}) noexcept
+        : backend_(backend), pipeline_(pipeline), running_(false), physics_(physics), config_(config),
+          pacer_(config.pacing) {}
+
+    ~Runtime() { stop_render_thread(); }
+
+    Runtime(const Runtime&) = delete;
+    Runtime& operator=(const Runtime&) = delete;
+
+    void push_layer(Layer* layer) {
+        layers_.push_back(layer);
+        update_jobs_.emplace_back();
+    }
 
-    ~Runtime() = default;
+    // Queue an event from any thread (audio callbacks, signal forwarding,
+    // network or extra input threads). Posted events are dispatched after the
+    // backend's input on the next frame. Returns false when the queue is full.
+    [[nodiscard]] bool post_event(const ege::Event& e) noexcept { return posted_events_.push(e); }
 
-    void push_layer(Layer* layer) { layers_.push_back(layer); }
+    [[nodiscard]] const RuntimeConfig& config() const noexcept { return config_; }
+
+    // Frame-time statistics of the current/last `run()`, including jitter.
+    // Read from the thread that calls `run()` (or after it returns).
+    [[nodiscard]] const FrameTimingStats& frame_stats() const noexcept { return pacer_.stats(); }
+
+    // Commands layers recorded that did not fit their frame's command buffer
+    // (see OverflowPolicy), summed over all frames. Simulation thread only.
+    [[nodiscard]] uint64_t dropped_commands() const noexcept { return dropped_commands_; }
+
+    // Visible region in command coordinates (e.g. the screen, or a camera's
+    // window onto it). Layers whose bounds miss it are not rendered, and
+    // their command buffer rejects or trims geometry outside it. Without a
+    // viewport nothing is culled. Simulation thread only.
+    void set_viewport(const ScreenRect& viewport) noexcept { viewport_ = viewport; has_viewport_ = true; }
+    void clear_viewport() noexcept { has_viewport_ = false; }
+    [[nodiscard]] const CullStats& cull_stats() const noexcept { return cull_stats_; }
 
     void run() {
-        running_ = true;
+        running_.store(true, std::memory_order_relaxed);
+        if (config_.sim_core >= 0) (void)pin_current_thread(config_.sim_core);
+        EGE_PROFILE_THREAD("simulation");
+        const bool threaded = config_.threading == ThreadingMode::Threaded;
+        if (threaded) start_render_thread();
+
         int frame_count = 0;
-        while (running_) {
-            // Poll input events
-            std::vector<ege::Event> events;
-            backend_.poll_input(events);
+        pacer_.reset(FramePacer::Clock::now());
+        while (running_.load(std::memory_order_relaxed)) {
+            // Poll input events into the fixed per-frame buffer, then append
+            // whatever other threads posted since the last frame.
+            const std::span<ege::Event> storage(events_);
+            std::size_t count = 0;
+            {
+                EGE_PROFILE_SCOPE("runtime.poll_input");
+                count = backend_.poll_input(storage);
+                count += posted_events_.pop_n(storage.subspan(count));
+            }
+            const std::span<const ege::Event> events = storage.first(count);
 
             // Dispatch events to layers (top-first); if consumed, stop propagation.
             // If we receive a Quit input event, request runtime stop.
-            for (const auto &ev : events) {
-                if (ev.is_shutdown_event()) {
-                    running_ = false;
-                    break;
-                }
-                for (auto it = layers_.rbegin(); it != layers_.rend(); ++it) {
-                    if ((*it)->on_event(ev)) break;
-                }
-            }
-
-            // Update layers and physics (fixed step)
-            const float dt = 1.0f / 60.0f;
-            for (auto* l : layers_) l->on_update(dt);
-            physics_.step(dt);
-
-            // Render: acquire a producer buffer once and let layers record
-            // commands into the same buffer. Layers should assume a valid
-            // frame is already available when `on_render()` is called and
-            // only push commands — they must NOT call `begin_frame()` or
-            // `submit_frame()` themselves.
             {
-                auto opt = pipeline_.begin_frame();
-                if (opt) {
-                    auto &refwrap = *opt; // reference_wrapper<CmdBuf>
-                    auto &buf = refwrap.get();
-                    // runtime provides the active buffer; bind it to each
-                    // layer, call `on_render`, then unbind.
-                    for (auto* l : layers_) {
-                        if (!l->is_visible()) continue;
-                        l->_bind_cmdbuf(&buf);
-                        l->on_render(frame_count);
-                        l->_unbind_cmdbuf();
+                EGE_PROFILE_SCOPE("runtime.dispatch");
+                for (const auto &ev : events) {
+                    if (ev.is_shutdown_event()) {
+                        running_.store(false, std::memory_order_relaxed);
+                        break;
+                    }
+                    for (auto it = layers_.rbegin(); it != layers_.rend(); ++it) {
+                        if ((*it)->on_event(ev)) break;
                     }
-                    pipeline_.submit_frame();
                 }
-                // if no buffer available, skip recording this frame
             }
 
-            // Consumer: drain any produced frames and present the latest one.
-            // Layers render in push order; consuming all and presenting the last
-            // ensures top-most layers drawn later appear on screen.
-            ege::FrameBuffer<1024> last_out;
-            bool have_frame = false;
-            while (true) {
-                uint32_t idx;
-                const auto &popped = pipeline_.try_consume(idx);
-                if (idx == UINT32_MAX) break;
-                ege::FrameBuffer<1024> tmp;
-                popped.decode(tmp);
-                // release this buffer immediately
-                assert(pipeline_.release_buffer(idx));
-                last_out = tmp;
-                have_frame = true;
+            // Update layers and physics in fixed steps covering the real
+            // time since the last frame.
+            const int steps = pacer_.begin_frame(FramePacer::Clock::now());
+            const float dt = pacer_.step_seconds();
+            for (int i = 0; i < steps; ++i) {
+                {
+                    EGE_PROFILE_SCOPE("runtime.update");
+                    update_layers(dt);
+                }
+                EGE_PROFILE_SCOPE("runtime.physics");
+                step_physics(dt);
             }
-            if (have_frame) {
-                backend_.present(last_out);
+
+            record_frame(frame_count, pacer_.alpha());
+            if (threaded) {
+                // Wake the render thread; it presents the newest frame.
+                frames_submitted_.fetch_add(1, std::memory_order_release);
+                frames_submitted_.notify_one();
+            } else {
+                present_latest();
             }
 
             ++frame_count;
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            pacer_.wait_for_next_frame();
         }
 
+        stop_render_thread();
+
         // Runtime stopping: notify layers to clean up in reverse order.
         for (auto it = layers_.rbegin(); it != layers_.rend(); ++it) {
             (*it)->on_exit();
         }
     }
 
-    void stop() { running_ = false; }
+    void stop() { running_.store(false, std::memory_order_relaxed); }
 
 private:
-    backend::Backend& backend_;
-    ege::SPSCRenderPipeline<1024,4,8>& pipeline_;
+    Backend& backend_;
+    Pipeline& pipeline_;
+    std::array<ege::Event, kMaxEventsPerFrame> events_{};
+    MPSCQueue<ege::Event, kPostedEventCapacity> posted_events_;
+
+    // Job payloads for `update_layers`, one per layer, sized by `push_layer`
+    // so fanning out never allocates.
+    struct UpdateSlot { Layer* layer = nullptr; float dt = 0.0f; };
+    std::vector<UpdateSlot> update_jobs_;
 
     std::vector<Layer*> layers_;
-    bool running_ = false;
+    std::atomic<bool> running_{false};
     PhysicsSystem& physics_;
+    RuntimeConfig config_;
+    FramePacer pacer_;
+    uint64_t dropped_commands_ = 0;
+    ScreenRect viewport_{};
+    bool has_viewport_ = false;
+    CullStats cull_stats_{};
+
+    // Render thread state (ThreadingMode::Threaded only).
+    std::thread render_thread_;
+    std::atomic<bool> render_running_{false};
+    std::atomic<uint32_t> frames_submitted_{0};
+
+    // Independent layers are fanned out as jobs while the remaining layers
+    // update in order on this thread; everything joins before physics and
+    // render recording.
+    void update_layers(float dt) {
+        JobSystem* jobs = config_.jobs;
+        if (jobs == nullptr) {
+            for (auto* l : layers_) l->on_update(dt);
+            return;
+        }
+        JobCounter counter;
+        std::size_t slot = 0;
+        for (auto* l : layers_) {
+            if (!l->parallel_update()) continue;
+            update_jobs_[slot] = UpdateSlot{l, dt};
+            jobs->submit([](void* data, std::size_t, std::size_t) {
+                auto* job = static_cast<UpdateSlot*>(data);
+                job->layer->on_update(job->dt);
+            }, &update_jobs_[slot], 0, 1, counter);
+            ++slot;
+        }
+        for (auto* l : layers_) {
+            if (!l->parallel_update()) l->on_update(dt);
+        }
+        jobs->wait(counter);
+    }
+
+    // With `parallel_physics` the solve is spread over the job system too.
+    void step_physics(float dt) {
+        if (JobSystem* jobs = config_.jobs; jobs != nullptr && config_.parallel_physics) {
+            physics_.step_parallel(dt, [jobs](std::size_t count, auto&& fn) { jobs->parallel_for(count, fn); });
+            return;
+        }
+        physics_.step(dt);
+    }
+
+    // Render: acquire a producer buffer once and let layers record
+    // commands into the same buffer. Layers should assume a valid
+    // frame is already available when `on_render()` is called and
+    // only push commands — they must NOT call `begin_frame()` or
+    // `submit_frame()` themselves.
+    void record_frame(int frame_count, float alpha) {
+        EGE_PROFILE_SCOPE("runtime.record");
+        auto opt = pipeline_.begin_frame();
+        if (!opt) return; // if no buffer available, skip recording this frame
+        auto &refwrap = *opt; // reference_wrapper<CmdBuf>
+        auto &buf = refwrap.get();
+        // begin_frame() already reset the buffer; switching encodings clears
+        // it again, so only do that the first time each buffer comes round.
+        if (buf.encoding() != config_.command_encoding) buf.set_encoding(config_.command_encoding);
+        if (has_viewport_) buf.set_viewport(viewport_);
+        else buf.clear_viewport();
+        // runtime provides the active buffer; bind it to each
+        // layer, call `on_render`, then unbind.
+        for (auto* l : layers_) {
+            if (!l->is_visible()) continue;
+            if (has_viewport_ && l->has_bounds() && !viewport_.intersects(l->bounds())) {
+                ++cull_stats_.culled_layers;
+                continue;
+            }
+            l->_bind_cmdbuf(&buf);
+            l->_set_interpolation_alpha(alpha);
+            l->on_render(frame_count);
+            l->_unbind_cmdbuf();
+        }
+        dropped_commands_ += buf.dropped_commands();
+        cull_stats_.culled_commands += buf.culled_commands();
+        cull_stats_.trimmed_commands += buf.trimmed_commands();
+        pipeline_.submit_frame();
+    }
+
+    // Consumer: drain any produced frames and present the latest one (a
+    // mailbox pipeline is consumed once). Older frames are released without
+    // being decoded; the newest is handed
+    // to the backend as a zero-copy view of its encoded bytes and released
+    // once `present` returns.
+    void present_latest() {
+        uint32_t latest = UINT32_MAX;
+        const typename Pipeline::CmdBuf* latest_buf = nullptr;
+        if constexpr (requires { Pipeline::kConsumesLatest; }) {
+            // A mailbox swap already skips stale frames; a second consume
+            // could take back the buffer about to be presented.
+            latest_buf = &pipeline_.try_consume(latest);
+        } else {
+            while (true) {
+                uint32_t idx;
+                const auto &popped = pipeline_.try_consume(idx);
+                if (idx == UINT32_MAX) break;
+                if (latest != UINT32_MAX) release(latest);
+                latest = idx;
+                latest_buf = &popped;
+            }
+        }
+        if (latest == UINT32_MAX) return;
+        EGE_PROFILE_SCOPE("runtime.present");
+        backend_.present(latest_buf->view());
+        release(latest);
+    }
+
+    void release(uint32_t idx) noexcept {
+        [[maybe_unused]] const bool released = pipeline_.release_buffer(idx);
+        assert(released);
+    }
+
+    void start_render_thread() {
+        render_running_.store(true, std::memory_order_release);
+        render_thread_ = std::thread([this] {
+            if (config_.render_core >= 0) (void)pin_current_thread(config_.render_core);
+            EGE_PROFILE_THREAD("render");
+            uint32_t seen = frames_submitted_.load(std::memory_order_acquire);
+            while (render_running_.load(std::memory_order_acquire)) {
+                present_latest();
+                // Sleep until the simulation thread submits another frame
+                // (or shutdown bumps the counter).
+                frames_submitted_.wait(seen, std::memory_order_acquire);
+                seen = frames_submitted_.load(std::memory_order_acquire);
+            }
+            // Present whatever was submitted last so every buffer is returned.
+            present_latest();
+        });
+    }
+
+    void stop_render_thread() {
+        if (!render_thread_.joinable()) return;
+        render_running_.store(false, std::memory_order_release);
+        frames_submitted_.fetch_add(1, std::memory_order_release);
+        frames_submitted_.notify_one();
+        render_thread_.join();
+    }
 };
 
 } // namespace ege
@@ -1,6 +1,6 @@
 #pragma once
 #include <cstddef>
-#include "../../../../src/engine/render_command.hpp"
+#include <ege/engine/command_buffer.hpp>
 
 namespace ege::backend {
 
@@ -10,7 +10,7 @@ struct ESP32Backend {
 
     bool init(std::size_t width, std::size_t height);
     void shutdown();
-    void present(const ege::FrameBuffer<1024>& frame);
+    void present(const ege::CommandView& frame);
 };
 
 } // namespace ege::backend
@@ -13,9 +13,9 @@ void ESP32Backend::shutdown() {
     std::cerr << "ESP32 backend (stub) shutdown.\n";
 }
 
-void ESP32Backend::present(const ege::FrameBuffer<1024>& frame) {
-    std::cerr << "ESP32 backend present (stub): commands=" << frame.size() << "\n";
-    (void)frame;
+void ESP32Backend::present(const ege::CommandView& frame) {
+    const std::size_t commands = frame.for_each([](const ege::RenderCommand&) {});
+    std::cerr << "ESP32 backend present (stub): commands=" << commands << "\n";
 }
 
 } // namespace ege::backend
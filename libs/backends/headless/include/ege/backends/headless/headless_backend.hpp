@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include <ege/engine/render_command.hpp>
+#include <ege/engine/command_buffer.hpp>
+#include <ege/engine/spsc_queue.hpp>
+#include <ege/engine/event.hpp>
+#include <ege/raster/tile_rasterizer.hpp>
+
+namespace ege::backend {
+
+// Backend without a window: rasterizes every frame into an in-memory ARGB8888
+// framebuffer and feeds scripted input, so rendering can be benchmarked and
+// compared against golden hashes on machines without a display.
+struct HeadlessBackend {
+    HeadlessBackend() = default;
+
+    bool init(std::size_t width, std::size_t height);
+    void shutdown();
+    // Rasterize the encoded commands of one frame (incrementally, like SDL).
+    void present(const ege::CommandView& frame);
+    void register_atlas(uint8_t id, const ege::SpriteAtlas* atlas) { raster_.set_atlas(id, atlas); }
+
+    // Framebuffer access for tests: `width() * height()` pixels, row pitch
+    // equal to the width.
+    [[nodiscard]] std::span<const uint32_t> pixels() const noexcept { return pixels_; }
+    [[nodiscard]] std::size_t width() const noexcept { return width_; }
+    [[nodiscard]] std::size_t height() const noexcept { return height_; }
+    [[nodiscard]] uint32_t pixel(std::size_t x, std::size_t y) const noexcept { return pixels_[y * width_ + x]; }
+    // 64-bit FNV-1a over the current framebuffer, stable across runs and
+    // platforms for the same commands; compare against golden values.
+    [[nodiscard]] uint64_t framebuffer_hash() const noexcept;
+    // Store the framebuffer hash of every presented frame in `log` (one
+    // slot per frame; frames past its end are not logged). Hashing costs a
+    // pass over the framebuffer, so it is off until a log is set.
+    void set_frame_log(std::span<uint64_t> log) noexcept { frame_log_ = log; }
+    [[nodiscard]] std::size_t frames_presented() const noexcept { return presented_; }
+    [[nodiscard]] const ege::raster::RasterStats& raster_stats() const noexcept { return raster_.stats(); }
+
+    // Scripted input: `event` is returned by the `poll_input` call with index
+    // `frame` (0-based), or by the first call after it if that one was full.
+    // Events for the same frame keep their scripting order.
+    void script(std::size_t frame, const ege::Event& event);
+    // Script an InputCode::Quit event, which stops `Runtime::run`.
+    void quit_at(std::size_t frame);
+    [[nodiscard]] std::size_t frames_polled() const noexcept { return polled_; }
+
+    std::size_t poll_input(std::span<ege::Event> out);
+    // Audio is not played; triggered sounds are only counted.
+    bool open_audio(int) { return true; }
+    void trigger_sound(uint32_t, float = 440.0f, uint32_t = 200) { ++sounds_; }
+    [[nodiscard]] std::size_t sounds_triggered() const noexcept { return sounds_; }
+    bool try_pop_event(ege::Event &out) { return event_queue_.pop(out); }
+    std::size_t drain_events(std::span<ege::Event> out) { return event_queue_.pop_n(out); }
+
+private:
+    struct ScriptedEvent {
+        std::size_t frame;
+        ege::Event event;
+    };
+
+    std::size_t width_ = 0;
+    std::size_t height_ = 0;
+    std::vector<uint32_t> pixels_;
+    ege::raster::TileRasterizer raster_;
+    std::span<uint64_t> frame_log_;
+    std::size_t presented_ = 0;
+    std::vector<ScriptedEvent> script_; // sorted by frame
+    std::size_t next_scripted_ = 0;
+    std::size_t polled_ = 0;
+    std::size_t sounds_ = 0;
+    ege::SPSCQueue<ege::Event, 1024> event_queue_;
+};
+
+} // namespace ege::backend
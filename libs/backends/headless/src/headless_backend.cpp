@@ -0,0 +1,66 @@
+#include <ege/backends/headless/headless_backend.hpp>
+#include <algorithm>
+
+namespace ege::backend {
+
+bool HeadlessBackend::init(std::size_t width, std::size_t height) {
+    width_ = width;
+    height_ = height;
+    pixels_.assign(width_ * height_, 0u);
+    raster_.resize(width_, height_);
+    raster_.invalidate();
+    presented_ = 0;
+    return true;
+}
+
+void HeadlessBackend::shutdown() {
+    pixels_ = {};
+    width_ = height_ = 0;
+}
+
+void HeadlessBackend::present(const ege::CommandView& frame) {
+    raster_.render_incremental(frame, ege::raster::Target{pixels_.data(), width_, height_, width_});
+    if (presented_ < frame_log_.size()) frame_log_[presented_] = framebuffer_hash();
+    ++presented_;
+}
+
+uint64_t HeadlessBackend::framebuffer_hash() const noexcept {
+    // Byte-wise FNV-1a over little-endian pixels, so the value does not
+    // depend on host byte order.
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (const uint32_t px : pixels_) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            h ^= (px >> shift) & 0xFFu;
+            h *= 0x100000001b3ull;
+        }
+    }
+    return h;
+}
+
+void HeadlessBackend::script(std::size_t frame, const ege::Event& event) {
+    // Insert after every event already scripted for `frame`.
+    const auto pos = std::upper_bound(script_.begin() + static_cast<std::ptrdiff_t>(next_scripted_), script_.end(), frame,
+                                      [](std::size_t f, const ScriptedEvent& s) { return f < s.frame; });
+    script_.insert(pos, ScriptedEvent{frame, event});
+}
+
+void HeadlessBackend::quit_at(std::size_t frame) {
+    ege::Event quit{};
+    quit.type = ege::EventType::Input;
+    quit.id = uint32_t(ege::InputCode::Quit);
+    quit.payload.i = 1;
+    script(frame, quit);
+}
+
+std::size_t HeadlessBackend::poll_input(std::span<ege::Event> out) {
+    // Move this frame's scripted events into the queue; whatever does not
+    // fit stays scripted and goes out with a later poll.
+    while (next_scripted_ < script_.size() && script_[next_scripted_].frame <= polled_) {
+        if (!event_queue_.push(script_[next_scripted_].event)) break;
+        ++next_scripted_;
+    }
+    ++polled_;
+    return event_queue_.pop_n(out);
+}
+
+} // namespace ege::backend
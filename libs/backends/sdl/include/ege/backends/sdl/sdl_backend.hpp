@@ -1,11 +1,15 @@
 #pragma once
 #include <cstdint>
 #include <cstddef>
+#include <mutex>
+#include <span>
 #include <vector>
 #include <ege/engine/render_command.hpp>
+#include <ege/engine/command_buffer.hpp>
 #include <ege/engine/spsc_queue.hpp>
 #include <ege/engine/event.hpp>
-#include <cstdint>
+#include <ege/raster/palette.hpp>
+#include <ege/raster/tile_rasterizer.hpp>
 // Forward-declare SDL types to avoid forcing consumers to have SDL headers in their include path.
 extern "C" {
     struct SDL_Window;
@@ -17,28 +21,61 @@ using SDL_AudioDeviceID = uint32_t;
 namespace ege::backend {
 
 struct SDLBackend {
+    // CPU-side framebuffer format. Indexed8 keeps one palette index per pixel
+    // and expands changed regions through `palette()` straight into the
+    // texture at present time.
+    enum class PixelMode : uint8_t { Argb8888, Indexed8 };
+
     SDLBackend();
     ~SDLBackend();
 
-    bool init(std::size_t width, std::size_t height);
+    bool init(std::size_t width, std::size_t height, PixelMode mode = PixelMode::Argb8888);
     void shutdown();
-    void present(const ege::FrameBuffer<1024>& frame);
-    // Input/audio bridging
-    void poll_input(std::vector<ege::Event>& out);
+    // Rasterize the encoded commands of one frame and show it.
+    void present(const ege::CommandView& frame);
+    // Make `atlas` available to sprite commands as `id` (nullptr removes it).
+    // The atlas and its pixels must outlive the registration.
+    void register_atlas(uint8_t id, const ege::SpriteAtlas* atlas) { raster_.set_atlas(id, atlas); }
+    // Indexed8 palette, owned by the game (simulation) thread. Edits are
+    // invisible to `present` until `publish_palette()` hands a copy over;
+    // the next present then re-expands the whole screen without
+    // re-rasterizing. Publishing once per frame, after the frame's edits,
+    // keeps a threaded render loop from seeing a half-rotated palette.
+    [[nodiscard]] ege::raster::Palette& palette() noexcept { return palette_; }
+    void publish_palette();
+    [[nodiscard]] PixelMode pixel_mode() const noexcept { return mode_; }
+    // Bytes held by the CPU-side framebuffer (w*h*4 or w*h).
+    [[nodiscard]] std::size_t framebuffer_bytes() const noexcept {
+        return pixels_.size() * sizeof(uint32_t) + indexed_.size();
+    }
+    // Input/audio bridging. Pumps SDL into the event queue, then moves up to
+    // `out.size()` queued events into `out`; returns the count written.
+    std::size_t poll_input(std::span<ege::Event> out);
     bool open_audio(int sample_rate = 44100);
     // Trigger a simple synthesized sound (frequency in Hz, duration in milliseconds).
     void trigger_sound(uint32_t sound_id, float frequency = 440.0f, uint32_t duration_ms = 200);
     // Pull APIs for event queue
     bool try_pop_event(ege::Event &out);
-    void drain_events(std::vector<ege::Event>& out);
+    std::size_t drain_events(std::span<ege::Event> out);
 
 private:
+    void present_indexed(const ege::CommandView& frame);
+
     SDL_Window* window_ = nullptr;
     SDL_Renderer* renderer_ = nullptr;
     SDL_Texture* texture_ = nullptr;
     std::size_t width_ = 0;
     std::size_t height_ = 0;
-    std::vector<uint32_t> pixels_; // ARGB8888
+    PixelMode mode_ = PixelMode::Argb8888;
+    std::vector<uint32_t> pixels_; // ARGB8888 mode
+    std::vector<uint8_t> indexed_; // Indexed8 mode
+    ege::raster::Palette palette_;   // game side, edited freely
+    ege::raster::Palette published_; // last published copy, guarded by palette_mutex_
+    ege::raster::Palette shown_;     // render side, used by present_indexed
+    std::mutex palette_mutex_;
+    uint32_t expanded_version_ = 0; // palette version last expanded
+    bool expanded_once_ = false;
+    ege::raster::TileRasterizer raster_;
     SDL_AudioDeviceID audio_dev_ = 0;
     int audio_rate_ = 0;
     // internal single-producer single-consumer queue for events
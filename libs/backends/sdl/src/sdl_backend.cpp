@@ -1,4 +1,5 @@
 #include <ege/backends/sdl/sdl_backend.hpp>
+#include <ege/engine/profiler.hpp>
 #include <SDL.h>
 #include <iostream>
 #include <algorithm>
@@ -19,10 +20,20 @@ void sdl_sigint_handler(int) {
 SDLBackend::SDLBackend() = default;
 SDLBackend::~SDLBackend() { shutdown(); }
 
-bool SDLBackend::init(std::size_t width, std::size_t height) {
+bool SDLBackend::init(std::size_t width, std::size_t height, PixelMode mode) {
     width_ = width;
     height_ = height;
-    pixels_.assign(width_ * height_, 0u);
+    mode_ = mode;
+    // Only the buffer for the selected mode is allocated.
+    if (mode_ == PixelMode::Indexed8) {
+        pixels_ = {};
+        indexed_.assign(width_ * height_, 0u);
+    } else {
+        indexed_ = {};
+        pixels_.assign(width_ * height_, 0u);
+    }
+    expanded_once_ = false;
+    raster_.resize(width_, height_);
 
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0) {
         std::cerr << "SDL_Init failed: " << SDL_GetError() << "\n";
@@ -78,56 +89,71 @@ void SDLBackend::shutdown() {
     SDL_Quit();
 }
 
-static inline void draw_filled_rect(std::vector<uint32_t> &pixels, std::size_t w, std::size_t h,
-                                    int x0, int y0, int rw, int rh, uint32_t color) {
-    int x1 = x0 + rw;
-    int y1 = y0 + rh;
-    x0 = std::max(0, x0);
-    y0 = std::max(0, y0);
-    x1 = std::min(static_cast<int>(w), x1);
-    y1 = std::min(static_cast<int>(h), y1);
-    for (int y = y0; y < y1; ++y) {
-        uint32_t *row = pixels.data() + static_cast<std::size_t>(y) * w;
-        for (int x = x0; x < x1; ++x) row[x] = color;
+void SDLBackend::present(const ege::CommandView& frame) {
+    if (mode_ == PixelMode::Indexed8) {
+        present_indexed(frame);
+        return;
+    }
+    // Rasterize straight from the encoded stream into the persistent pixel
+    // buffer (ARGB8888). Only tiles whose visible commands changed since the
+    // previous frame are redrawn.
+    raster_.render_incremental(frame, ege::raster::Target{pixels_.data(), width_, height_, width_});
+
+    // Upload just the changed regions; the texture keeps the rest.
+    EGE_PROFILE_SCOPE("sdl.upload");
+    const int src_pitch = static_cast<int>(width_ * sizeof(uint32_t));
+    for (const auto &r : raster_.dirty_rects()) {
+        const SDL_Rect rect{r.x, r.y, r.w, r.h};
+        const uint32_t* src = pixels_.data() + static_cast<std::size_t>(r.y) * width_ + static_cast<std::size_t>(r.x);
+        SDL_UpdateTexture(texture_, &rect, src, src_pitch);
     }
+
+    SDL_RenderClear(renderer_);
+    SDL_RenderCopy(renderer_, texture_, nullptr, nullptr);
+    SDL_RenderPresent(renderer_);
 }
 
-void SDLBackend::present(const ege::FrameBuffer<1024>& frame) {
-    // Decode FrameBuffer commands into pixel buffer (ARGB8888)
-    std::fill(pixels_.begin(), pixels_.end(), 0u);
-    for (std::size_t i = 0; i < frame.size(); ++i) {
-        const auto &cmd = frame.commands[i];
-        switch (cmd.type) {
-            case ege::RenderCommandType::Clear:
-                std::fill(pixels_.begin(), pixels_.end(), cmd.color);
-                break;
-            case ege::RenderCommandType::Rect:
-                draw_filled_rect(pixels_, width_, height_, cmd.rect.x, cmd.rect.y, cmd.rect.w, cmd.rect.h, cmd.color);
-                break;
-            default:
-                break;
-        }
+void SDLBackend::publish_palette() {
+    const std::lock_guard<std::mutex> lock(palette_mutex_);
+    published_ = palette_;
+}
+
+void SDLBackend::present_indexed(const ege::CommandView& frame) {
+    const ege::raster::IndexedTarget target{indexed_.data(), width_, height_, width_};
+    raster_.render_incremental(frame, target);
+    {
+        // Take the latest published palette; the game keeps editing its own.
+        const std::lock_guard<std::mutex> lock(palette_mutex_);
+        if (published_.version() != shown_.version()) shown_ = published_;
     }
 
-    // update texture and present
-    void* texPixels = nullptr;
-    int pitch = 0;
-    if (SDL_LockTexture(texture_, nullptr, &texPixels, &pitch) == 0) {
-        // copy rows (pitch may be larger than width*4)
-        for (std::size_t y = 0; y < height_; ++y) {
-            std::memcpy(static_cast<uint8_t*>(texPixels) + y * static_cast<std::size_t>(pitch),
-                        pixels_.data() + y * width_, width_ * sizeof(uint32_t));
-        }
+    // Expand indices through the palette directly into the locked texture.
+    // A palette change recolours every pixel, so it re-expands the whole
+    // screen; otherwise only the regions the rasterizer touched.
+    EGE_PROFILE_SCOPE("sdl.expand_upload");
+    const auto expand = [&](const ege::raster::DirtyRect& r) {
+        const SDL_Rect rect{r.x, r.y, r.w, r.h};
+        void* dst = nullptr;
+        int pitch = 0;
+        if (SDL_LockTexture(texture_, &rect, &dst, &pitch) != 0) return;
+        ege::raster::expand_indexed(target, shown_, r, static_cast<uint32_t*>(dst),
+                                    static_cast<std::size_t>(pitch) / sizeof(uint32_t));
         SDL_UnlockTexture(texture_);
+    };
+    if (!expanded_once_ || shown_.version() != expanded_version_) {
+        expand({0, 0, static_cast<int32_t>(width_), static_cast<int32_t>(height_)});
+        expanded_version_ = shown_.version();
+        expanded_once_ = true;
+    } else {
+        for (const auto &r : raster_.dirty_rects()) expand(r);
     }
 
     SDL_RenderClear(renderer_);
     SDL_RenderCopy(renderer_, texture_, nullptr, nullptr);
     SDL_RenderPresent(renderer_);
-    SDL_PumpEvents();
 }
 
-void SDLBackend::poll_input(std::vector<ege::Event>& out)
+std::size_t SDLBackend::poll_input(std::span<ege::Event> out)
 {
     // If a signal (SIGINT/SIGTERM) was received, enqueue a Quit input event.
     if (s_sigint_flag) {
@@ -186,11 +212,8 @@ void SDLBackend::poll_input(std::vector<ege::Event>& out)
         // enqueue into internal event queue; if full, drop event
         (void)event_queue_.push(e);
     }
-    // drain internal queue into out vector
-    ege::Event tmp;
-    while (event_queue_.pop(tmp)) {
-        out.push_back(tmp);
-    }
+    // drain internal queue into the caller's span
+    return event_queue_.pop_n(out);
 }
 
 bool SDLBackend::try_pop_event(ege::Event &out)
@@ -198,10 +221,9 @@ bool SDLBackend::try_pop_event(ege::Event &out)
     return event_queue_.pop(out);
 }
 
-void SDLBackend::drain_events(std::vector<ege::Event>& out)
+std::size_t SDLBackend::drain_events(std::span<ege::Event> out)
 {
-    ege::Event tmp;
-    while (event_queue_.pop(tmp)) out.push_back(tmp);
+    return event_queue_.pop_n(out);
 }
 
 bool SDLBackend::open_audio(int sample_rate)
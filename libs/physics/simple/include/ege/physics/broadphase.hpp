@@ -0,0 +1,212 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <ege/physics/collision.hpp>
+
+namespace ege { namespace physics {
+
+// Uniform-grid broadphase backed by a spatial hash.
+//
+// Every body is inserted into the single cell that contains its centre. As
+// long as the cell size is at least the largest body diameter, two bodies can
+// only overlap when their cells are equal or adjacent, so candidate pairs are
+// gathered from the 3x3 neighbourhood of each body. Cells are hashed into a
+// power-of-two bucket table and bodies are counting-sorted into one flat
+// array; all buffers are kept between builds so a steady-state step does not
+// allocate.
+class SpatialHashGrid {
+public:
+    SpatialHashGrid() = default;
+
+    // Pre-size internal buffers for `bodies` entries.
+    void reserve(std::size_t bodies) {
+        const std::size_t buckets = bucket_count_for(bodies);
+        cells_.reserve(bodies);
+        entries_.reserve(bodies);
+        bucket_start_.reserve(buckets + 1);
+        cursor_.reserve(buckets);
+        scratch_.reserve(64);
+    }
+
+    // Rebuild the grid for `count` bodies. `center(i)` must return the Vec2
+    // centre of body `i`.
+    template<typename CenterFn>
+    void build(std::size_t count, float cell_size, CenterFn &&center) {
+        count_ = count;
+        inv_cell_ = (cell_size > 0.0f) ? 1.0f / cell_size : 1.0f;
+        const std::size_t buckets = bucket_count_for(count);
+        mask_ = static_cast<uint32_t>(buckets - 1);
+
+        cells_.resize(count);
+        entries_.resize(count);
+        bucket_start_.assign(buckets + 1, 0u);
+        cursor_.resize(buckets);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const Vec2 c = center(i);
+            Cell cell{ to_cell(c.x), to_cell(c.y) };
+            cells_[i] = cell;
+            ++bucket_start_[hash(cell) + 1];
+        }
+        for (std::size_t b = 0; b < buckets; ++b) bucket_start_[b + 1] += bucket_start_[b];
+        std::copy(bucket_start_.begin(), bucket_start_.end() - 1, cursor_.begin());
+        // Scatter in ascending body order so every bucket stays sorted.
+        for (std::size_t i = 0; i < count; ++i) {
+            entries_[cursor_[hash(cells_[i])]++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    // Invoke `fn(i, j)` for every candidate pair with i < j. Pairs are visited
+    // in ascending (i, j) order, the same order a brute-force double loop uses.
+    // Only pairs whose lower index is below `first_limit` are reported.
+    template<typename PairFn>
+    void for_each_pair(PairFn &&fn, std::size_t first_limit = SIZE_MAX) {
+        const std::size_t limit = std::min(count_, first_limit);
+        for (std::size_t i = 0; i < limit; ++i) {
+            const Cell ci = cells_[i];
+            scratch_.clear();
+            for (int32_t oy = -1; oy <= 1; ++oy) {
+                for (int32_t ox = -1; ox <= 1; ++ox) {
+                    const Cell n{ ci.x + ox, ci.y + oy };
+                    const uint32_t b = hash(n);
+                    for (uint32_t k = bucket_start_[b]; k < bucket_start_[b + 1]; ++k) {
+                        const uint32_t j = entries_[k];
+                        // Each pair is reported once, from its lower index.
+                        if (j <= i) continue;
+                        // Different cells may share a bucket; only accept the exact cell.
+                        if (cells_[j].x != n.x || cells_[j].y != n.y) continue;
+                        scratch_.push_back(j);
+                    }
+                }
+            }
+            std::sort(scratch_.begin(), scratch_.end());
+            for (uint32_t j : scratch_) fn(i, static_cast<std::size_t>(j));
+        }
+    }
+
+    // ---- Spatial partition for parallel solving ----
+    //
+    // `build_blocks` groups the bodies of the last `build` into square blocks
+    // of `block_cells` x `block_cells` cells and colours every block by the
+    // parity of its block coordinates (4 colours). A pair reported from a
+    // block only involves bodies within one cell of it, so with blocks at
+    // least 2 cells wide, blocks of the same colour never share a body and
+    // can be solved concurrently. Blocks are hashed into per-colour buckets;
+    // blocks that collide share a bucket and are simply solved together.
+
+    static constexpr uint32_t kBlockColours = 4;
+
+    void build_blocks(int32_t block_cells) {
+        block_cells_ = std::max<int32_t>(block_cells, 2);
+        std::size_t per_colour = 64;
+        while (per_colour * 8 < count_) per_colour <<= 1;
+        block_mask_ = static_cast<uint32_t>(per_colour - 1);
+        const std::size_t buckets = per_colour * kBlockColours;
+
+        block_of_.resize(count_);
+        block_entries_.resize(count_);
+        block_start_.assign(buckets + 1, 0u);
+        block_cursor_.resize(buckets);
+        for (std::size_t i = 0; i < count_; ++i) {
+            const uint32_t b = block_bucket(cells_[i]);
+            block_of_[i] = b;
+            ++block_start_[b + 1];
+        }
+        for (std::size_t b = 0; b < buckets; ++b) block_start_[b + 1] += block_start_[b];
+        std::copy(block_start_.begin(), block_start_.end() - 1, block_cursor_.begin());
+        for (std::size_t i = 0; i < count_; ++i) {
+            block_entries_[block_cursor_[block_of_[i]]++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    // Buckets per colour after `build_blocks`.
+    [[nodiscard]] std::size_t blocks_per_colour() const noexcept { return static_cast<std::size_t>(block_mask_) + 1; }
+
+    // Invoke `fn(i, j)` for every candidate pair (i < j, i < first_limit)
+    // whose lower body lies in bucket `bucket` of colour `colour`. Bodies are
+    // visited in ascending order and neighbours in a fixed cell order, so the
+    // sequence depends only on the body layout. Safe to call concurrently for
+    // different buckets of the same colour.
+    template<typename PairFn>
+    void for_each_pair_in_block(uint32_t colour, std::size_t bucket, PairFn &&fn,
+                                std::size_t first_limit = SIZE_MAX) const {
+        const std::size_t b = colour * blocks_per_colour() + bucket;
+        for (uint32_t k = block_start_[b]; k < block_start_[b + 1]; ++k) {
+            const uint32_t i = block_entries_[k];
+            if (i >= first_limit) break; // entries ascend, so the rest are beyond too
+            const Cell ci = cells_[i];
+            for (int32_t oy = -1; oy <= 1; ++oy) {
+                for (int32_t ox = -1; ox <= 1; ++ox) {
+                    const Cell n{ ci.x + ox, ci.y + oy };
+                    const uint32_t hb = hash(n);
+                    for (uint32_t e = bucket_start_[hb]; e < bucket_start_[hb + 1]; ++e) {
+                        const uint32_t j = entries_[e];
+                        if (j <= i) continue;
+                        if (cells_[j].x != n.x || cells_[j].y != n.y) continue;
+                        fn(static_cast<std::size_t>(i), static_cast<std::size_t>(j));
+                    }
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return count_; }
+    [[nodiscard]] std::size_t bucket_count() const noexcept { return cursor_.size(); }
+
+private:
+    struct Cell { int32_t x; int32_t y; };
+
+    static std::size_t bucket_count_for(std::size_t bodies) noexcept {
+        std::size_t b = 16;
+        while (b < bodies * 2) b <<= 1;
+        return b;
+    }
+
+    int32_t to_cell(float v) const noexcept {
+        // Clamp so far-away or non-finite coordinates cannot overflow int32.
+        float c = std::floor(v * inv_cell_);
+        if (!(c > -1.0e9f)) c = -1.0e9f;
+        if (c > 1.0e9f) c = 1.0e9f;
+        return static_cast<int32_t>(c);
+    }
+
+    static int32_t floor_div(int32_t v, int32_t d) noexcept {
+        return (v >= 0) ? v / d : -((-v + d - 1) / d);
+    }
+
+    uint32_t block_bucket(Cell c) const noexcept {
+        const int32_t bx = floor_div(c.x, block_cells_);
+        const int32_t by = floor_div(c.y, block_cells_);
+        const uint32_t colour = (static_cast<uint32_t>(bx) & 1u) | ((static_cast<uint32_t>(by) & 1u) << 1);
+        const uint32_t h = (static_cast<uint32_t>(bx) * 73856093u) ^ (static_cast<uint32_t>(by) * 19349663u);
+        return colour * (block_mask_ + 1) + (h & block_mask_);
+    }
+
+    uint32_t hash(Cell c) const noexcept {
+        const uint32_t hx = static_cast<uint32_t>(c.x) * 73856093u;
+        const uint32_t hy = static_cast<uint32_t>(c.y) * 19349663u;
+        return (hx ^ hy) & mask_;
+    }
+
+    std::vector<Cell> cells_;
+    std::vector<uint32_t> entries_;
+    std::vector<uint32_t> bucket_start_;
+    std::vector<uint32_t> cursor_;
+    std::vector<uint32_t> scratch_;
+    std::size_t count_ = 0;
+    float inv_cell_ = 1.0f;
+    uint32_t mask_ = 0;
+
+    std::vector<uint32_t> block_of_;
+    std::vector<uint32_t> block_entries_;
+    std::vector<uint32_t> block_start_;
+    std::vector<uint32_t> block_cursor_;
+    int32_t block_cells_ = 4;
+    uint32_t block_mask_ = 0;
+};
+
+} }
@@ -3,7 +3,11 @@
 #include <vector>
 #include <cstdint>
 #include <cmath>
+#include <algorithm>
+#include <utility>
 #include <ege/physics/collision.hpp>
+#include <ege/physics/broadphase.hpp>
+#include <ege/physics/soa_kernels.hpp>
 
 namespace ege { namespace physics {
 
@@ -18,69 +22,248 @@ struct Body {
     float radius = 0.0f; // if >0, treat as circle
 };
 
+// Mutable view of one body inside `SimplePhysics`' SoA storage. Fields alias
+// the per-field arrays, so writes through the view land in the simulation;
+// converting to `Body` takes a snapshot. A view is invalidated by
+// `add_body`/`set_inv_mass` (storage may grow or be repartitioned), the same
+// way a reference into a vector would be.
+//
+// `body(id)` used to return `Body&`. It now returns this view by value, so
+// `auto& b = ps.body(id)` no longer compiles (use `auto b` or `BodyRef b`),
+// and there is no `Body` object whose address could be taken.
+struct BodyRef {
+    Vec2 &pos;
+    Vec2 &vel;
+    const float &inv_mass; // change through SimplePhysics::set_inv_mass
+    float &hx;
+    float &hy;
+    float &radius;
+
+    operator Body() const noexcept { return Body{pos, vel, inv_mass, hx, hy, radius}; }
+};
+
+// Pair-generation strategy used by `SimplePhysics::step`.
+enum class Broadphase : uint8_t {
+    BruteForce = 0, // test every pair (n^2); reference path and default
+    // Uniform-grid spatial hash; only neighbouring bodies are tested. Cells
+    // are assigned before any pair is resolved, so a body pushed into a new
+    // overlap during the step is only caught on the next step, where brute
+    // force catches it right away.
+    SpatialHash,
+};
+
+// Bodies are stored structure-of-arrays: positions, velocities, half extents,
+// radii and inverse masses each live in their own contiguous array. Dynamic
+// bodies occupy slots [0, dynamic_count()) and static bodies follow, so
+// integration is a single branch-free kernel over the dynamic range and
+// static/static pairs are never visited. `BodyId`s stay stable through an
+// id -> slot indirection table.
 class SimplePhysics {
 public:
     SimplePhysics() = default;
 
+    void set_broadphase(Broadphase mode) noexcept { broadphase_ = mode; }
+    [[nodiscard]] Broadphase broadphase() const noexcept { return broadphase_; }
+
+    // Grid cell size for the spatial hash. Zero (the default) derives it each
+    // step from the largest body so every overlap stays within one cell ring.
+    // Smaller sizes would miss contacts, so the size used is never below
+    // twice the largest body extent.
+    void set_cell_size(float size) noexcept { cell_size_ = size; }
+    [[nodiscard]] float cell_size() const noexcept { return cell_size_; }
+
+    // Pre-size body and broadphase storage so stepping does not allocate.
+    void reserve(std::size_t bodies) {
+        pos_.reserve(bodies);
+        vel_.reserve(bodies);
+        half_.reserve(bodies);
+        radius_.reserve(bodies);
+        inv_mass_.reserve(bodies);
+        slot_of_.reserve(bodies);
+        id_of_.reserve(bodies);
+        grid_.reserve(bodies);
+    }
+    [[nodiscard]] std::size_t body_count() const noexcept { return pos_.size(); }
+    [[nodiscard]] std::size_t dynamic_count() const noexcept { return dynamic_count_; }
+
     BodyId add_body(const Body &b) {
-        bodies_.push_back(b);
-        return static_cast<BodyId>(bodies_.size()-1);
+        const BodyId id = static_cast<BodyId>(slot_of_.size());
+        const uint32_t slot = static_cast<uint32_t>(pos_.size());
+        pos_.push_back(b.pos);
+        vel_.push_back(b.vel);
+        half_.push_back(Vec2{b.hx, b.hy});
+        radius_.push_back(b.radius);
+        inv_mass_.push_back(b.inv_mass);
+        slot_of_.push_back(slot);
+        id_of_.push_back(id);
+        if (b.inv_mass != 0.0f) {
+            // Move into the dynamic partition by swapping with the first static slot.
+            swap_slots(slot, static_cast<uint32_t>(dynamic_count_));
+            ++dynamic_count_;
+        }
+        return id;
+    }
+
+    BodyRef body(BodyId id) { return ref(slot_of_.at(id)); }
+    Body body(BodyId id) const {
+        const uint32_t s = slot_of_.at(id);
+        return Body{pos_[s], vel_[s], inv_mass_[s], half_[s].x, half_[s].y, radius_[s]};
+    }
+
+    // Change a body's inverse mass, moving it between the dynamic and static
+    // partitions when it switches between zero and non-zero.
+    void set_inv_mass(BodyId id, float inv_mass) {
+        uint32_t s = slot_of_.at(id);
+        const bool was_dynamic = s < dynamic_count_;
+        const bool is_dynamic = inv_mass != 0.0f;
+        inv_mass_[s] = inv_mass;
+        if (was_dynamic == is_dynamic) return;
+        if (is_dynamic) {
+            swap_slots(s, static_cast<uint32_t>(dynamic_count_));
+            ++dynamic_count_;
+        } else {
+            --dynamic_count_;
+            swap_slots(s, static_cast<uint32_t>(dynamic_count_));
+        }
     }
-    Body &body(BodyId id) { return bodies_.at(id); }
-    const Body &body(BodyId id) const { return bodies_.at(id); }
 
     void step(float dt) {
         if (dt <= 0.0f) return;
-        for (auto &b : bodies_) {
-            if (b.inv_mass == 0.0f) continue;
-            b.pos.x += b.vel.x * dt;
-            b.pos.y += b.vel.y * dt;
+        integrate_linear(pos_.data(), vel_.data(), dynamic_count_, dt);
+        const std::size_t n = pos_.size();
+        // The lower slot of a pair is always < n, and pairs whose lower slot
+        // is static are static/static, so stop at the dynamic partition.
+        const std::size_t first_limit = dynamic_count_;
+        if (broadphase_ == Broadphase::SpatialHash) {
+            grid_.build(n, effective_cell_size(), [this](std::size_t i) { return pos_[i]; });
+            grid_.for_each_pair([this](std::size_t i, std::size_t j) { resolve_pair(i, j); }, first_limit);
+            return;
         }
         // naive n^2
-        const std::size_t n = bodies_.size();
-        for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t i = 0; i < first_limit; ++i) {
             for (std::size_t j = i+1; j < n; ++j) {
-                resolve_pair(bodies_[i], bodies_[j]);
+                resolve_pair(i, j);
             }
         }
     }
 
+    // Grid blocks (in cells per side) used as the unit of work by `step_parallel`.
+    static constexpr int32_t kParallelBlockCells = 4;
+
+    // Multithreaded step. `parallel_for(count, fn)` must call `fn(i)` for
+    // every i in [0, count), possibly concurrently, and return when all calls
+    // are done (for example `JobSystem::parallel_for`).
+    //
+    // Dynamic bodies integrate in independent chunks. Pairs are then solved
+    // block by block over the spatial hash: the four block colours run one
+    // after another, and all blocks of one colour run concurrently because
+    // they never share a body. Within a block the order is fixed, so the
+    // result is identical for any thread count and any scheduling, including
+    // a plain serial loop. It is not bit-identical to `step`, which resolves
+    // pairs in global index order. Always uses the spatial hash.
+    template<typename ParallelFor>
+    void step_parallel(float dt, ParallelFor &&parallel_for) {
+        if (dt <= 0.0f) return;
+        static constexpr std::size_t kChunk = 1024; // bodies per integration job
+        Vec2* p = pos_.data();
+        const Vec2* v = vel_.data();
+        const std::size_t count = dynamic_count_;
+        parallel_for((count + kChunk - 1) / kChunk, [p, v, count, dt](std::size_t c) {
+            const std::size_t begin = c * kChunk;
+            integrate_linear(p + begin, v + begin, std::min(kChunk, count - begin), dt);
+        });
+
+        const std::size_t first_limit = dynamic_count_;
+        grid_.build(pos_.size(), effective_cell_size(), [this](std::size_t i) { return pos_[i]; });
+        grid_.build_blocks(kParallelBlockCells);
+        for (uint32_t colour = 0; colour < SpatialHashGrid::kBlockColours; ++colour) {
+            parallel_for(grid_.blocks_per_colour(), [this, colour, first_limit](std::size_t block) {
+                grid_.for_each_pair_in_block(colour, block,
+                    [this](std::size_t i, std::size_t j) { resolve_pair(i, j); }, first_limit);
+            });
+        }
+    }
+
 private:
-    std::vector<Body> bodies_;
+    std::vector<Vec2> pos_;
+    std::vector<Vec2> vel_;
+    std::vector<Vec2> half_; // AABB half extents (hx, hy)
+    std::vector<float> radius_;
+    std::vector<float> inv_mass_;
+    std::vector<uint32_t> slot_of_; // BodyId -> slot
+    std::vector<BodyId> id_of_;     // slot -> BodyId
+    std::size_t dynamic_count_ = 0;
+    SpatialHashGrid grid_;
+    Broadphase broadphase_ = Broadphase::BruteForce;
+    float cell_size_ = 0.0f;
+
+    BodyRef ref(uint32_t s) noexcept {
+        return BodyRef{pos_[s], vel_[s], inv_mass_[s], half_[s].x, half_[s].y, radius_[s]};
+    }
+
+    void swap_slots(uint32_t a, uint32_t b) noexcept {
+        if (a == b) return;
+        std::swap(pos_[a], pos_[b]);
+        std::swap(vel_[a], vel_[b]);
+        std::swap(half_[a], half_[b]);
+        std::swap(radius_[a], radius_[b]);
+        std::swap(inv_mass_[a], inv_mass_[b]);
+        std::swap(id_of_[a], id_of_[b]);
+        slot_of_[id_of_[a]] = a;
+        slot_of_[id_of_[b]] = b;
+    }
+
+    // Circles use `radius`, everything else collides as an AABB; the larger
+    // extent bounds the body either way.
+    float extent(std::size_t s) const noexcept {
+        return std::max(radius_[s], std::max(half_[s].x, half_[s].y));
+    }
+
+    float effective_cell_size() const noexcept {
+        float e = 0.0f;
+        for (std::size_t s = 0; s < pos_.size(); ++s) e = std::max(e, extent(s));
+        const float min_size = (e > 0.0f) ? 2.0f * e : 1.0f;
+        return std::max(cell_size_, min_size);
+    }
 
-    static void resolve_pair(Body &a, Body &b) {
-        if (a.radius > 0.0f && b.radius > 0.0f) {
-            physics::Circle A{a.pos, a.radius};
-            physics::Circle B{b.pos, b.radius};
+    void resolve_pair(std::size_t ia, std::size_t ib) noexcept {
+        Vec2 &pa = pos_[ia];
+        Vec2 &pb = pos_[ib];
+        const float ma = inv_mass_[ia], mb = inv_mass_[ib];
+        const float ra = radius_[ia], rb = radius_[ib];
+        if (ra > 0.0f && rb > 0.0f) {
+            physics::Circle A{pa, ra};
+            physics::Circle B{pb, rb};
             if (!physics::circle_vs_circle(A,B)) return;
             // simple separation
-            float dx = b.pos.x - a.pos.x;
-            float dy = b.pos.y - a.pos.y;
+            float dx = pb.x - pa.x;
+            float dy = pb.y - pa.y;
             float dist = std::sqrt(dx*dx + dy*dy);
             if (dist == 0.0f) dist = 1e-4f;
-            float pen = (a.radius + b.radius) - dist;
+            float pen = (ra + rb) - dist;
             float nx = dx / dist, ny = dy / dist;
             float corr = pen * 0.5f;
-            if (a.inv_mass > 0.0f) { a.pos.x -= nx*corr; a.pos.y -= ny*corr; }
-            if (b.inv_mass > 0.0f) { b.pos.x += nx*corr; b.pos.y += ny*corr; }
+            if (ma > 0.0f) { pa.x -= nx*corr; pa.y -= ny*corr; }
+            if (mb > 0.0f) { pb.x += nx*corr; pb.y += ny*corr; }
         } else {
-            physics::AABB A{a.pos, a.hx, a.hy};
-            physics::AABB B{b.pos, b.hx, b.hy};
+            const Vec2 ha = half_[ia], hb = half_[ib];
+            physics::AABB A{pa, ha.x, ha.y};
+            physics::AABB B{pb, hb.x, hb.y};
             if (!physics::aabb_vs_aabb(A,B)) return;
-            float dx = b.pos.x - a.pos.x;
-            float px = (a.hx + b.hx) - std::fabs(dx);
-            float dy = b.pos.y - a.pos.y;
-            float py = (a.hy + b.hy) - std::fabs(dy);
+            float dx = pb.x - pa.x;
+            float px = (ha.x + hb.x) - std::fabs(dx);
+            float dy = pb.y - pa.y;
+            float py = (ha.y + hb.y) - std::fabs(dy);
             if (px < py) {
                 float sx = (dx < 0.0f) ? -1.0f : 1.0f;
                 float corr = px * 0.5f;
-                if (a.inv_mass > 0.0f) a.pos.x -= sx*corr;
-                if (b.inv_mass > 0.0f) b.pos.x += sx*corr;
+                if (ma > 0.0f) pa.x -= sx*corr;
+                if (mb > 0.0f) pb.x += sx*corr;
             } else {
                 float sy = (dy < 0.0f) ? -1.0f : 1.0f;
                 float corr = py * 0.5f;
-                if (a.inv_mass > 0.0f) a.pos.y -= sy*corr;
-                if (b.inv_mass > 0.0f) b.pos.y += sy*corr;
+                if (ma > 0.0f) pa.y -= sy*corr;
+                if (mb > 0.0f) pb.y += sy*corr;
             }
         }
     }
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <ege/physics/collision.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EGE_PHYSICS_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define EGE_PHYSICS_NEON 1
+#endif
+
+namespace ege { namespace physics {
+
+// Structure-of-arrays kernels used by `SimplePhysics`. They operate on flat
+// float arrays and contain no per-element branches, so they run four lanes at
+// a time on SSE2/NEON and stay vectorisable for the compiler elsewhere.
+
+// x[i] += v[i] * dt for i in [0, n).
+inline void integrate_linear(float* __restrict x, const float* __restrict v, std::size_t n, float dt) noexcept {
+    std::size_t i = 0;
+#if defined(EGE_PHYSICS_SSE2)
+    const __m128 vdt = _mm_set1_ps(dt);
+    for (; i + 4 <= n; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 pv = _mm_loadu_ps(v + i);
+        _mm_storeu_ps(x + i, _mm_add_ps(px, _mm_mul_ps(pv, vdt)));
+    }
+#elif defined(EGE_PHYSICS_NEON)
+    const float32x4_t vdt = vdupq_n_f32(dt);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t px = vld1q_f32(x + i);
+        float32x4_t pv = vld1q_f32(v + i);
+        // separate mul/add (no FMA) so results match the scalar tail bit for bit
+        vst1q_f32(x + i, vaddq_f32(px, vmulq_f32(pv, vdt)));
+    }
+#endif
+    for (; i < n; ++i) x[i] += v[i] * dt;
+}
+
+// p[i] += v[i] * dt for i in [0, n) over Vec2 arrays. Two bodies fill one
+// four-lane register; lanes are copied in and out with memcpy so Vec2 storage
+// is never read through a float pointer.
+inline void integrate_linear(Vec2* __restrict p, const Vec2* __restrict v, std::size_t n, float dt) noexcept {
+    static_assert(sizeof(Vec2) == 2 * sizeof(float), "two Vec2s must fill four float lanes");
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        float x[4];
+        float w[4];
+        std::memcpy(x, p + i, sizeof(x));
+        std::memcpy(w, v + i, sizeof(w));
+        integrate_linear(x, w, 4, dt);
+        std::memcpy(p + i, x, sizeof(x));
+    }
+    for (; i < n; ++i) {
+        p[i].x += v[i].x * dt;
+        p[i].y += v[i].y * dt;
+    }
+}
+
+} }
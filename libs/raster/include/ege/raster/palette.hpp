@@ -0,0 +1,54 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <ege/raster/tile_rasterizer.hpp>
+
+namespace ege::raster {
+
+// 256-entry ARGB8888 palette for indexed-mode rendering.
+//
+// Indexed frames store one byte per pixel; colours are resolved only when a
+// frame is expanded for display. Changing palette entries therefore recolours
+// everything that uses them without re-rasterizing: fades, flashes and
+// colour cycling (`rotate`) cost one expansion pass. `version()` changes on
+// every modification so a backend can tell it must re-expand the whole screen
+// rather than only the dirty rectangles.
+class Palette {
+public:
+    Palette() noexcept = default;
+
+    void set(uint8_t index, uint32_t argb) noexcept {
+        colors_[index] = argb;
+        ++version_;
+    }
+
+    // Copy `colors` into consecutive entries starting at `first` (truncated at 255).
+    void load(std::span<const uint32_t> colors, uint8_t first = 0) noexcept;
+
+    // Rotate entries [first, first + count) by `steps` places (colour cycling;
+    // positive steps move colours towards higher indices).
+    void rotate(uint8_t first, std::size_t count, int steps) noexcept;
+
+    [[nodiscard]] uint32_t operator[](uint8_t index) const noexcept { return colors_[index]; }
+    [[nodiscard]] const std::array<uint32_t, 256>& colors() const noexcept { return colors_; }
+    [[nodiscard]] uint32_t version() const noexcept { return version_; }
+
+private:
+    std::array<uint32_t, 256> colors_{};
+    uint32_t version_ = 0;
+};
+
+// Expand `region` of an indexed frame through `palette` into an ARGB8888
+// buffer. `dst` addresses the region's top-left pixel; `dst_pitch` is in
+// pixels.
+void expand_indexed(const IndexedTarget& src, const Palette& palette, const DirtyRect& region,
+                    uint32_t* dst, std::size_t dst_pitch) noexcept;
+
+// Same for RGB565 displays (e.g. SPI panels driven by the ESP32 backend).
+// The 565 LUT is rebuilt from `palette` on every call (256 entries).
+void expand_indexed_rgb565(const IndexedTarget& src, const Palette& palette, const DirtyRect& region,
+                           uint16_t* dst, std::size_t dst_pitch) noexcept;
+
+} // namespace ege::raster
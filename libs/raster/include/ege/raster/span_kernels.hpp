@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace ege::raster {
+
+// Pixel span kernels for ARGB8888 (0xAARRGGBB) framebuffers.
+//
+// `fill_span` and `blend_span` dispatch once to the widest implementation the
+// CPU supports (AVX2, SSE2, or the portable scalar loop, which is written so
+// compilers can auto-vectorise it for NEON). Every implementation produces
+// bit-identical results to `blend_pixel`.
+
+// Round x / 255 to nearest for x in [0, 65535]; exact, no division.
+[[nodiscard]] constexpr uint32_t div255(uint32_t x) noexcept {
+    x += 128u;
+    return (x + (x >> 8)) >> 8;
+}
+
+// Reference source-over blend of one ARGB8888 pixel `src` onto `dst`.
+// Colour channels: (s*a + d*(255-a)) / 255; alpha: a + da*(255-a) / 255.
+[[nodiscard]] constexpr uint32_t blend_pixel(uint32_t dst, uint32_t src) noexcept {
+    const uint32_t a = src >> 24;
+    const uint32_t inv = 255u - a;
+    uint32_t out = 0;
+    for (uint32_t shift = 0; shift < 24; shift += 8) {
+        const uint32_t s = (src >> shift) & 0xFFu;
+        const uint32_t d = (dst >> shift) & 0xFFu;
+        out |= div255(s * a + d * inv) << shift;
+    }
+    const uint32_t da = dst >> 24;
+    out |= div255(255u * a + da * inv) << 24;
+    return out;
+}
+
+[[nodiscard]] constexpr bool is_opaque(uint32_t argb) noexcept { return (argb >> 24) == 0xFFu; }
+
+// dst[i] = color for i in [0, n).
+void fill_span(uint32_t* dst, std::size_t n, uint32_t color) noexcept;
+
+// dst[i] = blend_pixel(dst[i], color) for i in [0, n). Opaque colours turn
+// into a fill and fully transparent ones into a no-op.
+void blend_span(uint32_t* dst, std::size_t n, uint32_t color) noexcept;
+
+// Sprite row copies. `src` is the first source pixel to read. The reversed
+// variants read src[0], src[-1], ... (horizontal flip). The keyed variants
+// leave dst untouched wherever the source pixel equals `key`. Vectorised with
+// SSE2 where available; the scalar loops are the reference.
+void copy_span(uint32_t* dst, const uint32_t* src, std::size_t n) noexcept;
+void copy_span_reversed(uint32_t* dst, const uint32_t* src, std::size_t n) noexcept;
+void copy_span_keyed(uint32_t* dst, const uint32_t* src, std::size_t n, uint32_t key) noexcept;
+void copy_span_keyed_reversed(uint32_t* dst, const uint32_t* src, std::size_t n, uint32_t key) noexcept;
+
+// One concrete kernel implementation; exposed so tests and benchmarks can
+// exercise every variant the CPU supports, not just the dispatched one.
+struct SpanKernels {
+    const char* name;
+    void (*fill)(uint32_t* dst, std::size_t n, uint32_t color) noexcept;
+    void (*blend)(uint32_t* dst, std::size_t n, uint32_t color) noexcept;
+};
+
+// Implementations usable on this CPU, scalar first and the dispatched
+// (widest) one last.
+[[nodiscard]] std::span<const SpanKernels> available_span_kernels() noexcept;
+
+} // namespace ege::raster
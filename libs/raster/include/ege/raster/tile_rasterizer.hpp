@@ -0,0 +1,185 @@
+#pragma once
+#include <cstddef>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <ege/engine/command_buffer.hpp>
+#include <ege/engine/sprite.hpp>
+
+namespace ege::raster {
+
+// Per-frame counters reported by the rasterizers.
+struct RasterStats {
+    uint64_t pixels_written = 0;   // framebuffer stores, including background fill
+    uint32_t commands = 0;         // drawable commands after clipping to the screen
+    uint32_t tiles = 0;            // tiles resolved
+    uint32_t occluded_items = 0;   // per-tile command draws skipped by occlusion
+    uint32_t occluded_commands = 0; // commands dropped whole: hidden under one opaque command above
+    uint32_t dirty_tiles = 0;      // tiles re-rasterized (all of them for a full render)
+    uint32_t skipped_sprites = 0;  // visible sprites with no atlas pixels for the target format
+};
+
+// Screen region (pixels, half-open) that changed since the previous frame.
+struct DirtyRect {
+    int32_t x = 0, y = 0, w = 0, h = 0;
+};
+
+// ARGB8888 render target: `pitch` is in pixels.
+struct Target {
+    uint32_t* pixels = nullptr;
+    std::size_t width = 0;
+    std::size_t height = 0;
+    std::size_t pitch = 0;
+};
+
+// 8-bit palette-indexed render target: one byte per pixel, `pitch` in
+// pixels (= bytes). In indexed mode the low byte of a command's colour is its
+// palette index and every command is opaque (there is nothing to blend
+// with). Sprites draw from their atlas' `indices` sheet; atlases without one
+// are skipped and counted in `RasterStats::skipped_sprites`. See palette.hpp
+// for converting to a display format.
+struct IndexedTarget {
+    uint8_t* pixels = nullptr;
+    std::size_t width = 0;
+    std::size_t height = 0;
+    std::size_t pitch = 0;
+};
+
+// Atlas id -> atlas table consulted for sprite commands. Sprites naming an
+// unregistered atlas, or a frame outside it, are skipped (and counted in
+// `RasterStats::skipped_sprites`).
+class SpriteAtlases {
+public:
+    void set(uint8_t id, const ege::SpriteAtlas* atlas) noexcept { atlases_[id] = atlas; }
+    [[nodiscard]] const ege::SpriteAtlas* get(uint8_t id) const noexcept { return atlases_[id]; }
+
+private:
+    std::array<const ege::SpriteAtlas*, 256> atlases_{};
+};
+
+// Reference rasterizer: clears the target to zero, then paints every command
+// in paint order (ascending `layer`, record order within a layer) over the
+// whole screen, one pixel at a time. Clears are ordering barriers: commands
+// are only reordered between them, so a clear always paints over everything
+// recorded before it and under everything recorded after it. Clears replace
+// pixels; rects with alpha < 0xFF are blended source-over (`blend_pixel`);
+// sprites copy their frame, skipping colour-keyed pixels. Kept as the
+// correctness baseline for `TileRasterizer`.
+void rasterize_reference(const ege::CommandView& frame, const Target& target, RasterStats* stats = nullptr,
+                         const SpriteAtlases* atlases = nullptr);
+// Indexed-mode reference: background index 0, then every command's index
+// (sprites copy indices from their atlas' `indices` sheet).
+void rasterize_reference(const ege::CommandView& frame, const IndexedTarget& target, RasterStats* stats = nullptr,
+                         const SpriteAtlases* atlases = nullptr);
+
+// Tile-binned rasterizer.
+//
+// Commands are clipped to the screen, stably sorted by `layer` (a counting
+// sort over the 256 layer values; record order is kept within a layer, and
+// commands recorded before the last clear are discarded since it hides them) and
+// binned into fixed-size tiles. Before binning, a command that lies entirely
+// under a single opaque command above it is dropped outright. Each
+// tile is then resolved once: its bin is scanned front to back for the
+// top-most command that covers the whole tile opaquely, everything below it
+// is skipped, and only the remaining commands are painted (back to front)
+// within the tile. A frame that starts with a full-screen clear therefore
+// never pays for the background fill, and stacked full-screen layers are
+// written once per pixel instead of once per layer. Output is identical to
+// `rasterize_reference`.
+//
+// Bin storage is kept between frames; call `resize` when the target size
+// changes.
+class TileRasterizer {
+public:
+    static constexpr int kTileSize = 32;
+
+    TileRasterizer() = default;
+    TileRasterizer(std::size_t width, std::size_t height) { resize(width, height); }
+
+    void resize(std::size_t width, std::size_t height);
+
+    // Register (or with nullptr, remove) the atlas sprite commands refer to
+    // as `id`. Invalidates incremental history. Tiles showing an atlas that
+    // stays registered are redrawn when its `version` changes.
+    void set_atlas(uint8_t id, const ege::SpriteAtlas* atlas) noexcept {
+        atlases_.set(id, atlas);
+        invalidate();
+    }
+
+    // Rasterize `frame` into `target` (whose size must match `resize`).
+    void render(const ege::CommandView& frame, const Target& target);
+
+    // Incremental variant for a persistent target that still holds the
+    // previously rendered frame. Each tile is summarised by a signature of
+    // the commands visible in it; only tiles whose signature changed since
+    // the last render are re-rasterized. The changed area is reported by
+    // `dirty_rects()` so backends can upload (or send over SPI) just those
+    // regions. The first call after `resize`/`invalidate` redraws everything.
+    void render_incremental(const ege::CommandView& frame, const Target& target);
+
+    // Indexed-mode equivalents (see IndexedTarget). Switching between ARGB and
+    // indexed targets drops the incremental history.
+    void render(const ege::CommandView& frame, const IndexedTarget& target);
+    void render_incremental(const ege::CommandView& frame, const IndexedTarget& target);
+
+    // Forget the previous frame; the next incremental render redraws all tiles.
+    void invalidate() noexcept { history_valid_ = false; }
+
+    // Regions written by the last render, merged from dirty tiles: runs of
+    // adjacent tiles in a row, then identical runs stacked vertically.
+    [[nodiscard]] const std::vector<DirtyRect>& dirty_rects() const noexcept { return dirty_rects_; }
+
+    [[nodiscard]] const RasterStats& stats() const noexcept { return stats_; }
+    [[nodiscard]] std::size_t tiles_x() const noexcept { return tiles_x_; }
+    [[nodiscard]] std::size_t tiles_y() const noexcept { return tiles_y_; }
+
+private:
+    // A command clipped to the screen, in half-open pixel bounds.
+    struct Prim {
+        int32_t x0, y0, x1, y1;
+        uint32_t color;
+        bool blend; // translucent or colour-keyed: never occludes
+        // Sprites only (atlas != nullptr): unclipped destination origin and
+        // the source frame.
+        const ege::SpriteAtlas* atlas;
+        int32_t ox, oy;
+        ege::SpriteFrame src;
+        uint8_t flags;
+        uint8_t layer;
+    };
+
+    void bin(const ege::CommandView& frame, bool indexed);
+    void sort_by_layer(uint8_t min_layer, uint8_t max_layer);
+    void drop_occluded();
+    // Index into the tile's bin of the first command that can be visible;
+    // `covered` is false when the zero background shows through.
+    uint32_t first_visible(std::size_t t, int32_t bx0, int32_t by0, int32_t bx1, int32_t by1, bool& covered) const noexcept;
+    uint64_t tile_signature(std::size_t t, uint32_t first, bool covered) const noexcept;
+    template<typename TargetT>
+    void paint_tile(std::size_t t, uint32_t first, bool covered,
+                    int32_t bx0, int32_t by0, int32_t bx1, int32_t by1, const TargetT& target);
+    template<typename TargetT>
+    void render_tiles(const ege::CommandView& frame, const TargetT& target, bool incremental);
+    void merge_dirty_rects();
+
+    std::size_t width_ = 0;
+    std::size_t height_ = 0;
+    std::size_t tiles_x_ = 0;
+    std::size_t tiles_y_ = 0;
+    std::vector<Prim> prims_;
+    std::vector<Prim> sorted_;          // scratch for sort_by_layer
+    std::vector<uint32_t> occluders_;   // prim indices, see drop_occluded
+    std::vector<uint32_t> bin_start_; // tiles + 1 offsets into bin_items_
+    std::vector<uint32_t> bin_cursor_;
+    std::vector<uint32_t> bin_items_; // prim indices, ascending per tile
+    std::vector<uint64_t> tile_sig_;  // signature of each tile's last render
+    std::vector<uint8_t> tile_dirty_;
+    std::vector<DirtyRect> dirty_rects_;
+    std::vector<DirtyRect> row_runs_;
+    bool history_valid_ = false;
+    bool history_indexed_ = false; // mode the history was rendered in
+    SpriteAtlases atlases_;
+    RasterStats stats_{};
+};
+
+} // namespace ege::raster
@@ -0,0 +1,60 @@
+#include <ege/raster/palette.hpp>
+#include <algorithm>
+
+namespace ege::raster {
+
+void Palette::load(std::span<const uint32_t> colors, uint8_t first) noexcept {
+    const std::size_t n = std::min(colors.size(), colors_.size() - first);
+    std::copy_n(colors.begin(), n, colors_.begin() + first);
+    ++version_;
+}
+
+void Palette::rotate(uint8_t first, std::size_t count, int steps) noexcept {
+    count = std::min(count, colors_.size() - first);
+    if (count < 2) return;
+    const auto n = static_cast<std::ptrdiff_t>(count);
+    std::ptrdiff_t s = steps % n;
+    if (s < 0) s += n;
+    const auto begin = colors_.begin() + first;
+    // Moving colours up by s == rotating left by count - s.
+    std::rotate(begin, begin + (n - s) % n, begin + n);
+    ++version_;
+}
+
+namespace {
+
+template<typename Pixel, typename Lut>
+void expand_rows(const IndexedTarget& src, const Lut& lut, const DirtyRect& r, Pixel* dst, std::size_t dst_pitch) noexcept {
+    const auto w = static_cast<std::size_t>(r.w);
+    for (int32_t y = 0; y < r.h; ++y) {
+        const uint8_t* s = src.pixels + static_cast<std::size_t>(r.y + y) * src.pitch + static_cast<std::size_t>(r.x);
+        Pixel* d = dst + static_cast<std::size_t>(y) * dst_pitch;
+        std::size_t x = 0;
+        for (; x + 4 <= w; x += 4) {
+            d[x] = lut[s[x]];
+            d[x + 1] = lut[s[x + 1]];
+            d[x + 2] = lut[s[x + 2]];
+            d[x + 3] = lut[s[x + 3]];
+        }
+        for (; x < w; ++x) d[x] = lut[s[x]];
+    }
+}
+
+} // namespace
+
+void expand_indexed(const IndexedTarget& src, const Palette& palette, const DirtyRect& region,
+                    uint32_t* dst, std::size_t dst_pitch) noexcept {
+    expand_rows(src, palette.colors(), region, dst, dst_pitch);
+}
+
+void expand_indexed_rgb565(const IndexedTarget& src, const Palette& palette, const DirtyRect& region,
+                           uint16_t* dst, std::size_t dst_pitch) noexcept {
+    std::array<uint16_t, 256> lut;
+    for (std::size_t i = 0; i < lut.size(); ++i) {
+        const uint32_t c = palette.colors()[i];
+        lut[i] = static_cast<uint16_t>(((c >> 8) & 0xF800u) | ((c >> 5) & 0x07E0u) | ((c >> 3) & 0x001Fu));
+    }
+    expand_rows(src, lut, region, dst, dst_pitch);
+}
+
+} // namespace ege::raster
@@ -0,0 +1,224 @@
+#include <ege/raster/span_kernels.hpp>
+#include <array>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EGE_RASTER_SSE2 1
+#endif
+
+#if defined(EGE_RASTER_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+// AVX2 is compiled per-function and selected at runtime, so the library
+// still runs on CPUs without it.
+#define EGE_RASTER_AVX2 1
+#define EGE_RASTER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace ege::raster {
+
+namespace {
+
+// Per-channel constants for blending one colour: out = div255(d * inv + s),
+// where s already includes the +128 rounding term. Channel order matches
+// the little-endian byte layout of 0xAARRGGBB: B, G, R, A.
+struct BlendTerms {
+    uint16_t s[4];
+    uint16_t inv;
+};
+
+BlendTerms blend_terms(uint32_t color) noexcept {
+    const uint32_t a = color >> 24;
+    BlendTerms t{};
+    t.inv = static_cast<uint16_t>(255u - a);
+    t.s[0] = static_cast<uint16_t>((color & 0xFFu) * a + 128u);
+    t.s[1] = static_cast<uint16_t>(((color >> 8) & 0xFFu) * a + 128u);
+    t.s[2] = static_cast<uint16_t>(((color >> 16) & 0xFFu) * a + 128u);
+    t.s[3] = static_cast<uint16_t>(255u * a + 128u);
+    return t;
+}
+
+// ---- scalar (portable; simple enough for compilers to vectorise on NEON) ----
+
+void fill_scalar(uint32_t* dst, std::size_t n, uint32_t color) noexcept {
+    for (std::size_t i = 0; i < n; ++i) dst[i] = color;
+}
+
+void blend_scalar_terms(uint32_t* dst, std::size_t n, const BlendTerms& t) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        const uint32_t d = dst[i];
+        uint32_t out = 0;
+        for (uint32_t c = 0; c < 4; ++c) {
+            const uint32_t x = ((d >> (c * 8)) & 0xFFu) * t.inv + t.s[c];
+            out |= ((x + (x >> 8)) >> 8) << (c * 8);
+        }
+        dst[i] = out;
+    }
+}
+
+void blend_scalar(uint32_t* dst, std::size_t n, uint32_t color) noexcept {
+    const uint32_t a = color >> 24;
+    if (a == 0u) return;
+    if (a == 255u) { fill_scalar(dst, n, color); return; }
+    blend_scalar_terms(dst, n, blend_terms(color));
+}
+
+// ---- SSE2 ----
+
+#if defined(EGE_RASTER_SSE2)
+void fill_sse2(uint32_t* dst, std::size_t n, uint32_t color) noexcept {
+    const __m128i c = _mm_set1_epi32(static_cast<int>(color));
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), c);
+    fill_scalar(dst + i, n - i, color);
+}
+
+void blend_sse2(uint32_t* dst, std::size_t n, uint32_t color) noexcept {
+    const uint32_t a = color >> 24;
+    if (a == 0u) return;
+    if (a == 255u) { fill_sse2(dst, n, color); return; }
+    const BlendTerms t = blend_terms(color);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i inv = _mm_set1_epi16(static_cast<short>(t.inv));
+    const __m128i s = _mm_setr_epi16(
+        static_cast<short>(t.s[0]), static_cast<short>(t.s[1]), static_cast<short>(t.s[2]), static_cast<short>(t.s[3]),
+        static_cast<short>(t.s[0]), static_cast<short>(t.s[1]), static_cast<short>(t.s[2]), static_cast<short>(t.s[3]));
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i* p = reinterpret_cast<__m128i*>(dst + i);
+        const __m128i d = _mm_loadu_si128(p);
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv), s);
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv), s);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+    }
+    blend_scalar_terms(dst + i, n - i, t);
+}
+#endif
+
+// ---- AVX2 ----
+
+#if defined(EGE_RASTER_AVX2)
+EGE_RASTER_TARGET_AVX2 void fill_avx2(uint32_t* dst, std::size_t n, uint32_t color) noexcept {
+    const __m256i c = _mm256_set1_epi32(static_cast<int>(color));
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), c);
+    fill_scalar(dst + i, n - i, color);
+}
+
+EGE_RASTER_TARGET_AVX2 void blend_avx2(uint32_t* dst, std::size_t n, uint32_t color) noexcept {
+    const uint32_t a = color >> 24;
+    if (a == 0u) return;
+    if (a == 255u) { fill_avx2(dst, n, color); return; }
+    const BlendTerms t = blend_terms(color);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i inv = _mm256_set1_epi16(static_cast<short>(t.inv));
+    const __m256i s = _mm256_set1_epi64x(static_cast<long long>(
+        static_cast<uint64_t>(t.s[0]) | (static_cast<uint64_t>(t.s[1]) << 16) |
+        (static_cast<uint64_t>(t.s[2]) << 32) | (static_cast<uint64_t>(t.s[3]) << 48)));
+    std::size_t i = 0;
+    // unpack/pack work within 128-bit lanes, so pixel order is preserved.
+    for (; i + 8 <= n; i += 8) {
+        __m256i* p = reinterpret_cast<__m256i*>(dst + i);
+        const __m256i d = _mm256_loadu_si256(p);
+        __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), inv), s);
+        __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), inv), s);
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+        _mm256_storeu_si256(p, _mm256_packus_epi16(lo, hi));
+    }
+    blend_scalar_terms(dst + i, n - i, t);
+}
+#endif
+
+struct KernelTable {
+    std::array<SpanKernels, 3> kernels{};
+    std::size_t count = 0;
+
+    KernelTable() noexcept {
+        kernels[count++] = SpanKernels{"scalar", fill_scalar, blend_scalar};
+#if defined(EGE_RASTER_SSE2)
+        kernels[count++] = SpanKernels{"sse2", fill_sse2, blend_sse2};
+#endif
+#if defined(EGE_RASTER_AVX2)
+        if (__builtin_cpu_supports("avx2")) kernels[count++] = SpanKernels{"avx2", fill_avx2, blend_avx2};
+#endif
+    }
+
+    const SpanKernels& best() const noexcept { return kernels[count - 1]; }
+};
+
+const KernelTable& table() noexcept {
+    static const KernelTable t;
+    return t;
+}
+
+} // namespace
+
+void fill_span(uint32_t* dst, std::size_t n, uint32_t color) noexcept {
+    static const auto fn = table().best().fill;
+    fn(dst, n, color);
+}
+
+void blend_span(uint32_t* dst, std::size_t n, uint32_t color) noexcept {
+    static const auto fn = table().best().blend;
+    fn(dst, n, color);
+}
+
+void copy_span(uint32_t* dst, const uint32_t* src, std::size_t n) noexcept {
+    std::memcpy(dst, src, n * sizeof(uint32_t));
+}
+
+void copy_span_reversed(uint32_t* dst, const uint32_t* src, std::size_t n) noexcept {
+    std::size_t i = 0;
+#if defined(EGE_RASTER_SSE2)
+    for (; i + 4 <= n; i += 4) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src - i - 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi32(s, 0x1B));
+    }
+#endif
+    for (; i < n; ++i) dst[i] = *(src - i);
+}
+
+void copy_span_keyed(uint32_t* dst, const uint32_t* src, std::size_t n, uint32_t key) noexcept {
+    std::size_t i = 0;
+#if defined(EGE_RASTER_SSE2)
+    const __m128i k = _mm_set1_epi32(static_cast<int>(key));
+    for (; i + 4 <= n; i += 4) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i keep = _mm_cmpeq_epi32(s, k); // all-ones where transparent
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, s)));
+    }
+#endif
+    for (; i < n; ++i) {
+        if (src[i] != key) dst[i] = src[i];
+    }
+}
+
+void copy_span_keyed_reversed(uint32_t* dst, const uint32_t* src, std::size_t n, uint32_t key) noexcept {
+    std::size_t i = 0;
+#if defined(EGE_RASTER_SSE2)
+    const __m128i k = _mm_set1_epi32(static_cast<int>(key));
+    for (; i + 4 <= n; i += 4) {
+        const __m128i s = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src - i - 3)), 0x1B);
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i keep = _mm_cmpeq_epi32(s, k);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, s)));
+    }
+#endif
+    for (; i < n; ++i) {
+        const uint32_t v = *(src - i);
+        if (v != key) dst[i] = v;
+    }
+}
+
+std::span<const SpanKernels> available_span_kernels() noexcept {
+    const auto& t = table();
+    return {t.kernels.data(), t.count};
+}
+
+} // namespace ege::raster
@@ -0,0 +1,560 @@
+#include <ege/raster/tile_rasterizer.hpp>
+#include <ege/raster/span_kernels.hpp>
+#include <ege/engine/profiler.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace ege::raster {
+
+namespace {
+
+// Paint a clipped rectangle: opaque spans are stored, translucent ones are
+// blended source-over.
+inline void fill_rows(const Target& t, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color, bool blend, RasterStats* stats) {
+    const std::size_t n = static_cast<std::size_t>(x1 - x0);
+    for (int32_t y = y0; y < y1; ++y) {
+        uint32_t* row = t.pixels + static_cast<std::size_t>(y) * t.pitch + static_cast<std::size_t>(x0);
+        if (blend) blend_span(row, n, color);
+        else fill_span(row, n, color);
+    }
+    if (stats) stats->pixels_written += static_cast<uint64_t>(n) * static_cast<uint64_t>(y1 - y0);
+}
+
+// Indexed mode: every span is a plain byte fill.
+inline void fill_rows(const IndexedTarget& t, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color, bool, RasterStats* stats) {
+    const std::size_t n = static_cast<std::size_t>(x1 - x0);
+    const auto index = static_cast<uint8_t>(color);
+    for (int32_t y = y0; y < y1; ++y) {
+        std::memset(t.pixels + static_cast<std::size_t>(y) * t.pitch + static_cast<std::size_t>(x0), index, n);
+    }
+    if (stats) stats->pixels_written += static_cast<uint64_t>(n) * static_cast<uint64_t>(y1 - y0);
+}
+
+// Clear replaces pixels outright; rects blend unless their colour is opaque.
+inline bool needs_blend(const ege::RenderCommand& cmd) noexcept {
+    return cmd.type != ege::RenderCommandType::Clear && !is_opaque(cmd.color);
+}
+
+// Atlas for a sprite command, or nullptr if it cannot be drawn (unregistered,
+// frame outside the sheet, or no pixels in the target's format).
+inline const ege::SpriteAtlas* sprite_atlas(const ege::RenderCommand& cmd, const SpriteAtlases* atlases,
+                                            bool indexed) noexcept {
+    if (atlases == nullptr) return nullptr;
+    const ege::SpriteAtlas* a = atlases->get(cmd.sprite.atlas);
+    const ege::SpriteFrame f{cmd.sprite.sx, cmd.sprite.sy, cmd.rect.w, cmd.rect.h};
+    if (a == nullptr || !a->contains(f)) return nullptr;
+    return (indexed ? a->indices != nullptr : a->pixels != nullptr) ? a : nullptr;
+}
+
+// Clip a rect to the screen. Returns false if nothing is visible.
+inline bool clip_rect(int32_t x, int32_t y, int32_t rw, int32_t rh, int32_t w, int32_t h,
+                      int32_t& x0, int32_t& y0, int32_t& x1, int32_t& y1) noexcept {
+    x0 = std::max(0, x);
+    y0 = std::max(0, y);
+    x1 = std::min(w, x + rw);
+    y1 = std::min(h, y + rh);
+    return x0 < x1 && y0 < y1;
+}
+
+// Clip a decoded command to the screen. Returns false if nothing is visible
+// (and for batches, whose instances are clipped one by one).
+inline bool clip_command(const ege::RenderCommand& cmd, int32_t w, int32_t h,
+                         int32_t& x0, int32_t& y0, int32_t& x1, int32_t& y1) noexcept {
+    switch (cmd.type) {
+        case ege::RenderCommandType::Clear:
+            return clip_rect(0, 0, w, h, w, h, x0, y0, x1, y1);
+        case ege::RenderCommandType::Rect:
+        case ege::RenderCommandType::Sprite:
+            return clip_rect(cmd.rect.x, cmd.rect.y, cmd.rect.w, cmd.rect.h, w, h, x0, y0, x1, y1);
+        default:
+            return false;
+    }
+}
+
+// Commands of `frame` stably sorted by layer (reference path only). Clears
+// are ordering barriers: only the runs between them are sorted.
+std::vector<ege::RenderCommand> paint_order(const ege::CommandView& frame) {
+    std::vector<ege::RenderCommand> cmds;
+    frame.for_each([&cmds](const ege::RenderCommand& cmd) { cmds.push_back(cmd); });
+    auto by_layer = [](const ege::RenderCommand& a, const ege::RenderCommand& b) { return a.layer < b.layer; };
+    auto run = cmds.begin();
+    for (auto it = cmds.begin(); it != cmds.end(); ++it) {
+        if (it->type != ege::RenderCommandType::Clear) continue;
+        std::stable_sort(run, it, by_layer);
+        run = it + 1;
+    }
+    std::stable_sort(run, cmds.end(), by_layer);
+    return cmds;
+}
+
+// Call `fn(cmd)` for a command, or once per instance (as a Rect) for a batch.
+template<typename Fn>
+inline void for_each_expanded(const ege::RenderCommand& cmd, Fn&& fn) {
+    if (cmd.type != ege::RenderCommandType::RectBatch) {
+        fn(cmd);
+        return;
+    }
+    ege::RenderCommand r{};
+    r.type = ege::RenderCommandType::Rect;
+    r.layer = cmd.layer;
+    r.color = cmd.color;
+    for (std::size_t i = 0; i < cmd.batch.count; ++i) {
+        const ege::RectInstance g = cmd.rect_instance(i);
+        r.rect = {g.x, g.y, g.w, g.h};
+        fn(static_cast<const ege::RenderCommand&>(r));
+    }
+}
+
+// Offset into the atlas of the texel sprite command `cmd` shows at screen
+// pixel (x, y).
+inline std::size_t sprite_texel(const ege::SpriteAtlas& a, const ege::RenderCommand& cmd, int32_t x, int32_t y) noexcept {
+    int32_t rx = x - cmd.rect.x;
+    int32_t ry = y - cmd.rect.y;
+    if (cmd.sprite.flags & ege::SpriteFlipX) rx = cmd.rect.w - 1 - rx;
+    if (cmd.sprite.flags & ege::SpriteFlipY) ry = cmd.rect.h - 1 - ry;
+    return static_cast<std::size_t>(cmd.sprite.sy + ry) * a.pitch + static_cast<std::size_t>(cmd.sprite.sx + rx);
+}
+
+// Blit the part of a sprite drawn at (ox, oy) inside [x0, x1) x [y0, y1), one row at a time.
+// Horizontal flips read the source row backwards; vertical flips pick the
+// mirrored source row.
+void blit_sprite(const Target& t, const ege::SpriteAtlas& a, int32_t ox, int32_t oy, const ege::SpriteFrame& src,
+                 uint8_t flags, int32_t x0, int32_t y0, int32_t x1, int32_t y1, RasterStats* stats) {
+    const std::size_t n = static_cast<std::size_t>(x1 - x0);
+    const bool flip_x = (flags & ege::SpriteFlipX) != 0;
+    const bool flip_y = (flags & ege::SpriteFlipY) != 0;
+    const int32_t rx = flip_x ? src.w - 1 - (x0 - ox) : x0 - ox;
+    for (int32_t y = y0; y < y1; ++y) {
+        const int32_t ry = flip_y ? src.h - 1 - (y - oy) : y - oy;
+        const uint32_t* s = a.pixels + static_cast<std::size_t>(src.y + ry) * a.pitch + static_cast<std::size_t>(src.x + rx);
+        uint32_t* d = t.pixels + static_cast<std::size_t>(y) * t.pitch + static_cast<std::size_t>(x0);
+        if (a.use_color_key) {
+            if (flip_x) copy_span_keyed_reversed(d, s, n, a.color_key);
+            else copy_span_keyed(d, s, n, a.color_key);
+        } else {
+            if (flip_x) copy_span_reversed(d, s, n);
+            else copy_span(d, s, n);
+        }
+    }
+    if (stats) stats->pixels_written += static_cast<uint64_t>(n) * static_cast<uint64_t>(y1 - y0);
+}
+
+// Indexed-mode blit from the atlas' index sheet; the low byte of
+// `color_key` is the transparent index.
+void blit_sprite(const IndexedTarget& t, const ege::SpriteAtlas& a, int32_t ox, int32_t oy, const ege::SpriteFrame& src,
+                 uint8_t flags, int32_t x0, int32_t y0, int32_t x1, int32_t y1, RasterStats* stats) {
+    const std::size_t n = static_cast<std::size_t>(x1 - x0);
+    const bool flip_x = (flags & ege::SpriteFlipX) != 0;
+    const bool flip_y = (flags & ege::SpriteFlipY) != 0;
+    const auto key = static_cast<uint8_t>(a.color_key);
+    const int32_t rx = flip_x ? src.w - 1 - (x0 - ox) : x0 - ox;
+    for (int32_t y = y0; y < y1; ++y) {
+        const int32_t ry = flip_y ? src.h - 1 - (y - oy) : y - oy;
+        const uint8_t* s = a.indices + static_cast<std::size_t>(src.y + ry) * a.pitch + static_cast<std::size_t>(src.x + rx);
+        uint8_t* d = t.pixels + static_cast<std::size_t>(y) * t.pitch + static_cast<std::size_t>(x0);
+        if (!flip_x && !a.use_color_key) {
+            std::memcpy(d, s, n);
+            continue;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            const uint8_t v = flip_x ? *(s - i) : s[i];
+            if (!a.use_color_key || v != key) d[i] = v;
+        }
+    }
+    if (stats) stats->pixels_written += static_cast<uint64_t>(n) * static_cast<uint64_t>(y1 - y0);
+}
+
+} // namespace
+
+void rasterize_reference(const ege::CommandView& frame, const Target& target, RasterStats* stats,
+                         const SpriteAtlases* atlases) {
+    if (stats) *stats = RasterStats{};
+    const int32_t w = static_cast<int32_t>(target.width);
+    const int32_t h = static_cast<int32_t>(target.height);
+    if (w == 0 || h == 0) return;
+    fill_rows(target, 0, 0, w, h, 0u, false, stats);
+    auto draw = [&](const ege::RenderCommand& cmd) {
+        int32_t x0, y0, x1, y1;
+        if (!clip_command(cmd, w, h, x0, y0, x1, y1)) return;
+        if (cmd.type == ege::RenderCommandType::Sprite) {
+            const ege::SpriteAtlas* a = sprite_atlas(cmd, atlases, false);
+            if (a == nullptr) {
+                if (stats) ++stats->skipped_sprites;
+                return;
+            }
+            for (int32_t y = y0; y < y1; ++y) {
+                uint32_t* row = target.pixels + static_cast<std::size_t>(y) * target.pitch;
+                for (int32_t x = x0; x < x1; ++x) {
+                    const uint32_t v = a->pixels[sprite_texel(*a, cmd, x, y)];
+                    if (!a->use_color_key || v != a->color_key) row[x] = v;
+                }
+            }
+            if (stats) stats->pixels_written += static_cast<uint64_t>(x1 - x0) * static_cast<uint64_t>(y1 - y0);
+            if (stats) ++stats->commands;
+            return;
+        }
+        const bool blend = needs_blend(cmd);
+        for (int32_t y = y0; y < y1; ++y) {
+            uint32_t* row = target.pixels + static_cast<std::size_t>(y) * target.pitch;
+            // Per-pixel reference blend, independent of the span kernels.
+            for (int32_t x = x0; x < x1; ++x) row[x] = blend ? blend_pixel(row[x], cmd.color) : cmd.color;
+        }
+        if (stats) stats->pixels_written += static_cast<uint64_t>(x1 - x0) * static_cast<uint64_t>(y1 - y0);
+        if (stats) ++stats->commands;
+    };
+    for (const auto& cmd : paint_order(frame)) for_each_expanded(cmd, draw);
+}
+
+void rasterize_reference(const ege::CommandView& frame, const IndexedTarget& target, RasterStats* stats,
+                         const SpriteAtlases* atlases) {
+    if (stats) *stats = RasterStats{};
+    const int32_t w = static_cast<int32_t>(target.width);
+    const int32_t h = static_cast<int32_t>(target.height);
+    if (w == 0 || h == 0) return;
+    fill_rows(target, 0, 0, w, h, 0u, false, stats);
+    auto draw = [&](const ege::RenderCommand& cmd) {
+        int32_t x0, y0, x1, y1;
+        if (!clip_command(cmd, w, h, x0, y0, x1, y1)) return;
+        if (cmd.type == ege::RenderCommandType::Sprite) {
+            const ege::SpriteAtlas* a = sprite_atlas(cmd, atlases, true);
+            if (a == nullptr) {
+                if (stats) ++stats->skipped_sprites;
+                return;
+            }
+            const auto key = static_cast<uint8_t>(a->color_key);
+            for (int32_t y = y0; y < y1; ++y) {
+                uint8_t* row = target.pixels + static_cast<std::size_t>(y) * target.pitch;
+                for (int32_t x = x0; x < x1; ++x) {
+                    const uint8_t v = a->indices[sprite_texel(*a, cmd, x, y)];
+                    if (!a->use_color_key || v != key) row[x] = v;
+                }
+            }
+            if (stats) stats->pixels_written += static_cast<uint64_t>(x1 - x0) * static_cast<uint64_t>(y1 - y0);
+            if (stats) ++stats->commands;
+            return;
+        }
+        for (int32_t y = y0; y < y1; ++y) {
+            uint8_t* row = target.pixels + static_cast<std::size_t>(y) * target.pitch;
+            for (int32_t x = x0; x < x1; ++x) row[x] = static_cast<uint8_t>(cmd.color);
+        }
+        if (stats) stats->pixels_written += static_cast<uint64_t>(x1 - x0) * static_cast<uint64_t>(y1 - y0);
+        if (stats) ++stats->commands;
+    };
+    for (const auto& cmd : paint_order(frame)) for_each_expanded(cmd, draw);
+}
+
+void TileRasterizer::resize(std::size_t width, std::size_t height) {
+    width_ = width;
+    height_ = height;
+    constexpr std::size_t T = kTileSize;
+    tiles_x_ = (width + T - 1) / T;
+    tiles_y_ = (height + T - 1) / T;
+    const std::size_t tiles = tiles_x_ * tiles_y_;
+    bin_start_.assign(tiles + 1, 0u);
+    bin_cursor_.assign(tiles, 0u);
+    tile_sig_.assign(tiles, 0u);
+    tile_dirty_.assign(tiles, 0u);
+    history_valid_ = false;
+}
+
+void TileRasterizer::bin(const ege::CommandView& frame, bool indexed) {
+    const int32_t w = static_cast<int32_t>(width_);
+    const int32_t h = static_cast<int32_t>(height_);
+    prims_.clear();
+    uint32_t cleared = 0;
+    uint8_t min_layer = UINT8_MAX, max_layer = 0;
+    for (const auto& cmd : frame) {
+        if (cmd.type == ege::RenderCommandType::Clear) {
+            // Clears are ordering barriers and replace every pixel, so
+            // nothing recorded before one can show, whatever its layer.
+            cleared += static_cast<uint32_t>(prims_.size());
+            prims_.clear();
+            min_layer = UINT8_MAX;
+            max_layer = 0;
+        }
+        Prim p{};
+        p.layer = static_cast<uint8_t>(cmd.layer);
+        min_layer = std::min(min_layer, p.layer);
+        max_layer = std::max(max_layer, p.layer);
+        if (cmd.type == ege::RenderCommandType::RectBatch) {
+            // Fast path: colour and blend mode are shared, so each instance
+            // is just a load and a clip straight into the prim list.
+            p.color = indexed ? (cmd.color & 0xFFu) : cmd.color;
+            p.blend = !indexed && !is_opaque(cmd.color);
+            const uint8_t* g = cmd.batch.data;
+            for (std::size_t i = 0; i < cmd.batch.count; ++i, g += sizeof(ege::RectInstance)) {
+                ege::RectInstance r;
+                std::memcpy(&r, g, sizeof(r));
+                if (clip_rect(r.x, r.y, r.w, r.h, w, h, p.x0, p.y0, p.x1, p.y1)) prims_.push_back(p);
+            }
+            continue;
+        }
+        if (!clip_command(cmd, w, h, p.x0, p.y0, p.x1, p.y1)) continue;
+        if (cmd.type == ege::RenderCommandType::Sprite) {
+            p.atlas = sprite_atlas(cmd, &atlases_, indexed);
+            if (p.atlas == nullptr) {
+                ++stats_.skipped_sprites;
+                continue;
+            }
+            p.ox = cmd.rect.x;
+            p.oy = cmd.rect.y;
+            p.src = ege::SpriteFrame{cmd.sprite.sx, cmd.sprite.sy, cmd.rect.w, cmd.rect.h};
+            p.flags = cmd.sprite.flags;
+            p.blend = p.atlas->use_color_key; // keyed sprites show what is below
+        } else if (indexed) {
+            p.color = cmd.color & 0xFFu;
+            p.blend = false;
+        } else {
+            p.color = cmd.color;
+            p.blend = needs_blend(cmd);
+        }
+        prims_.push_back(p);
+    }
+    stats_.commands = static_cast<uint32_t>(prims_.size()) + cleared;
+    stats_.occluded_commands += cleared;
+    if (min_layer < max_layer) sort_by_layer(min_layer, max_layer);
+    drop_occluded();
+
+    // Counting sort of (tile, prim) pairs: count, prefix-sum, scatter. Prims
+    // are scattered in paint order so every bin stays in paint order.
+    std::fill(bin_start_.begin(), bin_start_.end(), 0u);
+    auto for_each_tile = [this](const Prim& p, auto&& fn) {
+        const std::size_t tx0 = static_cast<std::size_t>(p.x0) / kTileSize;
+        const std::size_t ty0 = static_cast<std::size_t>(p.y0) / kTileSize;
+        const std::size_t tx1 = static_cast<std::size_t>(p.x1 - 1) / kTileSize;
+        const std::size_t ty1 = static_cast<std::size_t>(p.y1 - 1) / kTileSize;
+        for (std::size_t ty = ty0; ty <= ty1; ++ty)
+            for (std::size_t tx = tx0; tx <= tx1; ++tx) fn(ty * tiles_x_ + tx);
+    };
+    for (const auto& p : prims_) {
+        for_each_tile(p, [this](std::size_t t) { ++bin_start_[t + 1]; });
+    }
+    const std::size_t tiles = tiles_x_ * tiles_y_;
+    for (std::size_t t = 0; t < tiles; ++t) bin_start_[t + 1] += bin_start_[t];
+    std::copy(bin_start_.begin(), bin_start_.end() - 1, bin_cursor_.begin());
+    bin_items_.resize(bin_start_[tiles]);
+    for (std::size_t i = 0; i < prims_.size(); ++i) {
+        for_each_tile(prims_[i], [this, i](std::size_t t) {
+            bin_items_[bin_cursor_[t]++] = static_cast<uint32_t>(i);
+        });
+    }
+}
+
+void TileRasterizer::sort_by_layer(uint8_t min_layer, uint8_t max_layer) {
+    // Stable counting sort on the layer byte: count, prefix-sum, scatter.
+    std::array<uint32_t, 257> start{};
+    for (const auto& p : prims_) ++start[static_cast<std::size_t>(p.layer) + 1];
+    for (std::size_t l = min_layer; l <= max_layer; ++l) start[l + 1] += start[l];
+    sorted_.resize(prims_.size());
+    for (const auto& p : prims_) sorted_[start[p.layer]++] = p;
+    prims_.swap(sorted_);
+}
+
+void TileRasterizer::drop_occluded() {
+    // Occluders: opaque prims of at least one tile's area. Only the largest
+    // kMaxOccluders are tested so the pass stays linear in the prim count.
+    constexpr std::size_t kMaxOccluders = 16;
+    constexpr int64_t kMinArea = int64_t{kTileSize} * kTileSize;
+    auto area = [this](uint32_t i) {
+        const Prim& p = prims_[i];
+        return int64_t{p.x1 - p.x0} * int64_t{p.y1 - p.y0};
+    };
+    occluders_.clear();
+    for (uint32_t i = 0; i < prims_.size(); ++i) {
+        if (!prims_[i].blend && area(i) >= kMinArea) occluders_.push_back(i);
+    }
+    if (occluders_.empty()) return;
+    if (occluders_.size() > kMaxOccluders) {
+        std::nth_element(occluders_.begin(), occluders_.begin() + kMaxOccluders - 1, occluders_.end(),
+                         [&area](uint32_t a, uint32_t b) { return area(a) > area(b); });
+        occluders_.resize(kMaxOccluders);
+    }
+    std::sort(occluders_.begin(), occluders_.end());
+
+    // Keep a prim unless an occluder later in paint order contains it.
+    std::size_t out = 0;
+    for (uint32_t i = 0; i < prims_.size(); ++i) {
+        const Prim& p = prims_[i];
+        bool hidden = false;
+        for (auto it = std::upper_bound(occluders_.begin(), occluders_.end(), i); it != occluders_.end(); ++it) {
+            const Prim& o = prims_[*it];
+            if (o.x0 <= p.x0 && o.y0 <= p.y0 && o.x1 >= p.x1 && o.y1 >= p.y1) { hidden = true; break; }
+        }
+        if (hidden) {
+            ++stats_.occluded_commands;
+            continue;
+        }
+        // Occluder indices refer to the uncompacted list; occluders are only
+        // read at positions > i, which have not been moved yet.
+        prims_[out++] = p;
+    }
+    prims_.resize(out);
+}
+
+uint32_t TileRasterizer::first_visible(std::size_t t, int32_t bx0, int32_t by0, int32_t bx1, int32_t by1,
+                                       bool& covered) const noexcept {
+    const uint32_t begin = bin_start_[t];
+    const uint32_t end = bin_start_[t + 1];
+    // Front to back: find the top-most opaque command that hides the whole
+    // tile; translucent commands let what is beneath show through.
+    for (uint32_t k = end; k-- > begin;) {
+        const Prim& p = prims_[bin_items_[k]];
+        if (!p.blend && p.x0 <= bx0 && p.y0 <= by0 && p.x1 >= bx1 && p.y1 >= by1) {
+            covered = true;
+            return k;
+        }
+    }
+    covered = false;
+    return begin;
+}
+
+uint64_t TileRasterizer::tile_signature(std::size_t t, uint32_t first, bool covered) const noexcept {
+    // Everything that determines the tile's pixels: whether the background
+    // shows and the visible commands in paint order. Commands are clipped to
+    // the screen, not the tile, so a rect moving within the screen changes
+    // the signature of every tile it touches.
+    uint64_t h = covered ? 0x9E3779B97F4A7C15ull : 0x6A09E667F3BCC909ull;
+    auto mix = [&h](uint64_t v) {
+        h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+    };
+    const uint32_t end = bin_start_[t + 1];
+    for (uint32_t k = first; k < end; ++k) {
+        const Prim& p = prims_[bin_items_[k]];
+        mix((static_cast<uint64_t>(static_cast<uint32_t>(p.x0)) << 32) | static_cast<uint32_t>(p.y0));
+        mix((static_cast<uint64_t>(static_cast<uint32_t>(p.x1)) << 32) | static_cast<uint32_t>(p.y1));
+        mix((static_cast<uint64_t>(p.color) << 1) | (p.blend ? 1u : 0u));
+        if (p.atlas != nullptr) {
+            mix(reinterpret_cast<std::uintptr_t>(p.atlas));
+            mix(p.atlas->version);
+            mix((static_cast<uint64_t>(static_cast<uint32_t>(p.ox)) << 32) | static_cast<uint32_t>(p.oy));
+            mix((static_cast<uint64_t>(static_cast<uint16_t>(p.src.x)) << 48) |
+                (static_cast<uint64_t>(static_cast<uint16_t>(p.src.y)) << 32) |
+                (static_cast<uint64_t>(static_cast<uint16_t>(p.src.w)) << 16) |
+                static_cast<uint64_t>(static_cast<uint16_t>(p.src.h)));
+            mix(p.flags);
+        }
+    }
+    mix(end - first);
+    return h;
+}
+
+template<typename TargetT>
+void TileRasterizer::paint_tile(std::size_t t, uint32_t first, bool covered,
+                                int32_t bx0, int32_t by0, int32_t bx1, int32_t by1, const TargetT& target) {
+    stats_.occluded_items += first - bin_start_[t];
+    if (!covered) fill_rows(target, bx0, by0, bx1, by1, 0u, false, &stats_);
+
+    // Back to front over what is left, clipped to the tile.
+    const uint32_t end = bin_start_[t + 1];
+    for (uint32_t k = first; k < end; ++k) {
+        const Prim& p = prims_[bin_items_[k]];
+        const int32_t x0 = std::max(p.x0, bx0), y0 = std::max(p.y0, by0);
+        const int32_t x1 = std::min(p.x1, bx1), y1 = std::min(p.y1, by1);
+        if (p.atlas != nullptr) {
+            blit_sprite(target, *p.atlas, p.ox, p.oy, p.src, p.flags, x0, y0, x1, y1, &stats_);
+            continue;
+        }
+        fill_rows(target, x0, y0, x1, y1, p.color, p.blend, &stats_);
+    }
+}
+
+template<typename TargetT>
+void TileRasterizer::render_tiles(const ege::CommandView& frame, const TargetT& target, bool incremental) {
+    assert(target.width == width_ && target.height == height_);
+    constexpr bool indexed = std::is_same_v<TargetT, IndexedTarget>;
+    stats_ = RasterStats{};
+    dirty_rects_.clear();
+    if (width_ == 0 || height_ == 0) return;
+    {
+        EGE_PROFILE_SCOPE("raster.decode_bin");
+        bin(frame, indexed);
+    }
+    EGE_PROFILE_SCOPE("raster.paint");
+    const bool diff = incremental && history_valid_ && history_indexed_ == indexed;
+    history_indexed_ = indexed;
+    for (std::size_t ty = 0; ty < tiles_y_; ++ty) {
+        for (std::size_t tx = 0; tx < tiles_x_; ++tx) {
+            const std::size_t t = ty * tiles_x_ + tx;
+            const int32_t bx0 = static_cast<int32_t>(tx * kTileSize);
+            const int32_t by0 = static_cast<int32_t>(ty * kTileSize);
+            const int32_t bx1 = std::min(bx0 + kTileSize, static_cast<int32_t>(width_));
+            const int32_t by1 = std::min(by0 + kTileSize, static_cast<int32_t>(height_));
+            bool covered = false;
+            const uint32_t first = first_visible(t, bx0, by0, bx1, by1, covered);
+            const uint64_t sig = tile_signature(t, first, covered);
+            const bool dirty = !diff || sig != tile_sig_[t];
+            tile_sig_[t] = sig;
+            tile_dirty_[t] = dirty ? 1u : 0u;
+            ++stats_.tiles;
+            if (!dirty) continue;
+            ++stats_.dirty_tiles;
+            paint_tile(t, first, covered, bx0, by0, bx1, by1, target);
+        }
+    }
+    history_valid_ = true;
+    merge_dirty_rects();
+}
+
+void TileRasterizer::merge_dirty_rects() {
+    const int32_t w = static_cast<int32_t>(width_);
+    const int32_t h = static_cast<int32_t>(height_);
+    std::size_t open_begin = 0; // dirty_rects_ entries that may still grow downwards
+    for (std::size_t ty = 0; ty < tiles_y_; ++ty) {
+        // Horizontal runs of dirty tiles in this row.
+        row_runs_.clear();
+        const int32_t y0 = static_cast<int32_t>(ty * kTileSize);
+        const int32_t y1 = std::min(y0 + kTileSize, h);
+        for (std::size_t tx = 0; tx < tiles_x_;) {
+            if (!tile_dirty_[ty * tiles_x_ + tx]) { ++tx; continue; }
+            const std::size_t run_begin = tx;
+            while (tx < tiles_x_ && tile_dirty_[ty * tiles_x_ + tx]) ++tx;
+            const int32_t x0 = static_cast<int32_t>(run_begin * kTileSize);
+            const int32_t x1 = std::min(static_cast<int32_t>(tx * kTileSize), w);
+            row_runs_.push_back(DirtyRect{x0, y0, x1 - x0, y1 - y0});
+        }
+        // Extend a rect from the previous row when its run matches exactly.
+        const std::size_t open_end = dirty_rects_.size();
+        for (const auto& run : row_runs_) {
+            bool merged = false;
+            for (std::size_t i = open_begin; i < open_end; ++i) {
+                DirtyRect& r = dirty_rects_[i];
+                if (r.x == run.x && r.w == run.w && r.y + r.h == run.y) {
+                    r.h += run.h;
+                    merged = true;
+                    break;
+                }
+            }
+            if (!merged) dirty_rects_.push_back(run);
+        }
+        // Rects that did not grow into this row are closed; only those that
+        // end at this row's bottom edge stay open. Keep them contiguous.
+        std::size_t keep = open_begin;
+        for (std::size_t i = open_begin; i < dirty_rects_.size(); ++i) {
+            if (dirty_rects_[i].y + dirty_rects_[i].h == y1) continue;
+            std::swap(dirty_rects_[keep++], dirty_rects_[i]);
+        }
+        open_begin = keep;
+    }
+}
+
+void TileRasterizer::render(const ege::CommandView& frame, const Target& target) {
+    render_tiles(frame, target, false);
+}
+
+void TileRasterizer::render_incremental(const ege::CommandView& frame, const Target& target) {
+    render_tiles(frame, target, true);
+}
+
+void TileRasterizer::render(const ege::CommandView& frame, const IndexedTarget& target) {
+    render_tiles(frame, target, false);
+}
+
+void TileRasterizer::render_incremental(const ege::CommandView& frame, const IndexedTarget& target) {
+    render_tiles(frame, target, true);
+}
+
+} // namespace ege::raster
@@ -2,33 +2,94 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <algorithm>
 
 namespace ege {
 
-StaticArena::StaticArena(void* buffer, std::size_t size) noexcept
+namespace {
+bool filled_with(const uint8_t* p, const uint8_t* end, uint8_t pattern) noexcept
+{
+    return std::all_of(p, end, [pattern](uint8_t b) { return b == pattern; });
+}
+} // anonymous
+
+StaticArena::StaticArena(void* buffer, std::size_t size, const char* name) noexcept
   : m_start(reinterpret_cast<uint8_t*>(buffer)),
     m_ptr(reinterpret_cast<uint8_t*>(buffer)),
     m_end(reinterpret_cast<uint8_t*>(buffer) + size)
 {
+    if (name != nullptr) {
+        m_entry.name = name;
+        m_entry.owner = this;
+        m_entry.usage = [](const void* owner) { return static_cast<const StaticArena*>(owner)->usage(); };
+        memory::register_entry(m_entry);
+    }
+}
+
+StaticArena::~StaticArena()
+{
+    if (m_entry.usage != nullptr) memory::unregister_entry(m_entry);
 }
 
 void* StaticArena::allocate(std::size_t size, std::size_t align) noexcept
 {
     std::uintptr_t curr = reinterpret_cast<std::uintptr_t>(m_ptr);
     std::size_t offset = (align - (curr % align)) % align;
-    if (m_ptr + offset + size > m_end) return nullptr;
+    if (offset + size > static_cast<std::size_t>(m_end - m_ptr)) {
+        ++m_failed;
+        return nullptr;
+    }
     uint8_t* result = m_ptr + offset;
+    if (m_canary && !filled_with(m_ptr, result + size, m_canary_pattern)) ++m_canary_violations;
     m_ptr = result + size;
+    ++m_allocations;
+    m_wasted += offset;
+    m_peak = std::max(m_peak, used());
     return result;
 }
 
 void StaticArena::reset() noexcept
 {
     m_ptr = m_start;
+    if (m_canary) std::memset(m_start, m_canary_pattern, capacity());
 }
 
 std::size_t StaticArena::capacity() const noexcept { return static_cast<std::size_t>(m_end - m_start); }
 std::size_t StaticArena::used() const noexcept { return static_cast<std::size_t>(m_ptr - m_start); }
 
+void StaticArena::clear_stats() noexcept
+{
+    m_peak = used();
+    m_allocations = 0;
+    m_failed = 0;
+    m_wasted = 0;
+    m_canary_violations = 0;
+}
+
+void StaticArena::enable_canary(uint8_t pattern) noexcept
+{
+    m_canary = true;
+    m_canary_pattern = pattern;
+    std::memset(m_ptr, pattern, static_cast<std::size_t>(m_end - m_ptr));
+}
+
+bool StaticArena::check_canary() const noexcept
+{
+    return !m_canary || (m_canary_violations == 0 && filled_with(m_ptr, m_end, m_canary_pattern));
+}
+
+MemoryUsage StaticArena::usage() const noexcept
+{
+    MemoryUsage u;
+    u.block_size = capacity();
+    u.used = used();
+    u.peak = m_peak;
+    u.allocations = m_allocations;
+    u.failed = m_failed;
+    u.wasted_alignment = m_wasted;
+    u.canary_ok = check_canary();
+    return u;
+}
+
 } // namespace ege
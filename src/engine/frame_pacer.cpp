@@ -0,0 +1,87 @@
+#include <ege/engine/frame_pacer.hpp>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace ege {
+
+FramePacer::FramePacer(FramePacerConfig config) noexcept
+    : config_(config),
+      step_(1.0 / (config.update_hz > 0.0 ? config.update_hz : 60.0))
+{
+    if (config_.target_fps > 0.0) {
+        frame_period_ = std::chrono::duration_cast<Clock::duration>(Seconds(1.0 / config_.target_fps));
+    }
+    if (config_.max_updates_per_frame < 1) config_.max_updates_per_frame = 1;
+}
+
+void FramePacer::reset(Clock::time_point now) noexcept
+{
+    last_frame_ = now;
+    next_deadline_ = now + frame_period_;
+    accumulator_ = Seconds(0.0);
+    started_ = true;
+    stats_ = {};
+    m2_ = 0.0;
+}
+
+int FramePacer::begin_frame(Clock::time_point now) noexcept
+{
+    if (!started_) reset(now);
+    const Seconds elapsed = std::max(Seconds(now - last_frame_), Seconds(0.0));
+    last_frame_ = now;
+    if (elapsed.count() > 0.0) record_interval(elapsed.count() * 1000.0);
+
+    accumulator_ += elapsed;
+    int steps = static_cast<int>(std::floor(accumulator_ / step_));
+    if (steps > config_.max_updates_per_frame) {
+        stats_.dropped_steps += static_cast<uint64_t>(steps - config_.max_updates_per_frame);
+        steps = config_.max_updates_per_frame;
+        // Keep only the fractional step so alpha stays meaningful.
+        accumulator_ = Seconds(std::fmod(accumulator_.count(), step_.count()));
+    } else {
+        accumulator_ -= step_ * steps;
+    }
+    return steps;
+}
+
+float FramePacer::alpha() const noexcept
+{
+    const double a = accumulator_ / step_;
+    return static_cast<float>(std::clamp(a, 0.0, 1.0));
+}
+
+void FramePacer::wait_for_next_frame() noexcept
+{
+    if (frame_period_ == Clock::duration::zero()) return;
+    const Clock::time_point now = Clock::now();
+    if (now >= next_deadline_) {
+        // Missed the deadline: schedule from now rather than bursting frames
+        // to catch up on the ones already lost.
+        next_deadline_ = (now - next_deadline_ >= frame_period_) ? now + frame_period_ : next_deadline_ + frame_period_;
+        return;
+    }
+    const Clock::duration remaining = next_deadline_ - now;
+    if (remaining > config_.spin_threshold) std::this_thread::sleep_for(remaining - config_.spin_threshold);
+    while (Clock::now() < next_deadline_) { }
+    next_deadline_ += frame_period_;
+}
+
+void FramePacer::record_interval(double ms) noexcept
+{
+    ++stats_.frames;
+    stats_.last_ms = ms;
+    if (stats_.frames == 1) {
+        stats_.min_ms = ms;
+        stats_.max_ms = ms;
+    } else {
+        stats_.min_ms = std::min(stats_.min_ms, ms);
+        stats_.max_ms = std::max(stats_.max_ms, ms);
+    }
+    const double delta = ms - stats_.mean_ms;
+    stats_.mean_ms += delta / static_cast<double>(stats_.frames);
+    m2_ += delta * (ms - stats_.mean_ms);
+    stats_.jitter_ms = std::sqrt(m2_ / static_cast<double>(stats_.frames));
+}
+
+} // namespace ege
@@ -0,0 +1,177 @@
+#include <ege/engine/job_system.hpp>
+#include <algorithm>
+
+namespace ege {
+
+namespace {
+// Worker index of the calling thread for the JobSystem it belongs to.
+thread_local const JobSystem* t_owner = nullptr;
+thread_local std::size_t t_worker = 0;
+}
+
+bool JobSystem::WorkQueue::push_back(const Job& j) noexcept
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (size == kQueueCapacity) return false;
+    jobs[(front + size) % kQueueCapacity] = j;
+    ++size;
+    return true;
+}
+
+bool JobSystem::WorkQueue::pop_back(Job& out) noexcept
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (size == 0) return false;
+    --size;
+    out = jobs[(front + size) % kQueueCapacity];
+    return true;
+}
+
+bool JobSystem::WorkQueue::pop_front(Job& out) noexcept
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (size == 0) return false;
+    out = jobs[front];
+    front = (front + 1) % kQueueCapacity;
+    --size;
+    return true;
+}
+
+JobSystem::JobSystem(std::size_t workers)
+{
+    if (workers == 0) workers = std::thread::hardware_concurrency();
+    if (workers == 0) workers = 1;
+    queues_.reserve(workers);
+    for (std::size_t i = 0; i < workers; ++i) queues_.push_back(std::make_unique<WorkQueue>());
+    t_owner = this;
+    t_worker = 0;
+    threads_.reserve(workers - 1);
+    for (std::size_t i = 1; i < workers; ++i) threads_.emplace_back([this, i] { worker_main(i); });
+}
+
+JobSystem::~JobSystem()
+{
+    running_.store(false, std::memory_order_release);
+    work_epoch_.fetch_add(1, std::memory_order_release);
+    work_epoch_.notify_all();
+    for (auto& t : threads_) t.join();
+    if (t_owner == this) t_owner = nullptr;
+}
+
+std::size_t JobSystem::current_worker() const noexcept
+{
+    return (t_owner == this) ? t_worker : 0;
+}
+
+void JobSystem::submit(JobFn fn, void* data, std::size_t begin, std::size_t end, JobCounter& counter)
+{
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+    enqueue(Job{fn, data, begin, end, &counter});
+}
+
+void JobSystem::submit_after(JobCounter& dependency, JobFn fn, void* data, std::size_t begin, std::size_t end,
+                             JobCounter& counter)
+{
+    const Job job{fn, data, begin, end, &counter};
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(deferred_mutex_);
+        // Publish the parked job before checking the dependency; a job that
+        // finishes the dependency checks `deferred_count_` after its
+        // decrement, so one of the two sides always sees the other.
+        deferred_count_.fetch_add(1, std::memory_order_seq_cst);
+        if (dependency.pending.load(std::memory_order_seq_cst) != 0) {
+            for (auto& d : deferred_) {
+                if (d.dependency != nullptr) continue;
+                d = Deferred{job, &dependency};
+                return;
+            }
+        }
+        deferred_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    wait(dependency); // already done, or no free slot
+    enqueue(job);
+}
+
+void JobSystem::enqueue(const Job& job) noexcept
+{
+    if (!queues_[current_worker()]->push_back(job)) {
+        execute(job); // queue full: degrade to running inline
+        return;
+    }
+    work_epoch_.fetch_add(1, std::memory_order_release);
+    work_epoch_.notify_one();
+}
+
+void JobSystem::execute(const Job& job) noexcept
+{
+    job.fn(job.data, job.begin, job.end);
+    // Only parked jobs are looked at after the decrement: a waiter may free
+    // the counter as soon as it reads zero.
+    if (job.counter->pending.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+        deferred_count_.load(std::memory_order_seq_cst) != 0) {
+        release_deferred();
+    }
+}
+
+// Move every parked job whose dependency reached zero to this worker's
+// deque. Dependencies of parked jobs are alive by contract, so they may be
+// read here.
+void JobSystem::release_deferred() noexcept
+{
+    // One at a time, so no batch buffer is needed on small task stacks.
+    for (;;) {
+        Job ready;
+        {
+            std::lock_guard<std::mutex> lock(deferred_mutex_);
+            auto it = std::find_if(deferred_.begin(), deferred_.end(), [](const Deferred& d) {
+                return d.dependency != nullptr && d.dependency->pending.load(std::memory_order_acquire) == 0;
+            });
+            if (it == deferred_.end()) return;
+            ready = it->job;
+            it->dependency = nullptr;
+            deferred_count_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        enqueue(ready);
+    }
+}
+
+bool JobSystem::run_one(std::size_t self) noexcept
+{
+    Job job;
+    if (queues_[self]->pop_back(job)) {
+        execute(job);
+        return true;
+    }
+    const std::size_t n = queues_.size();
+    for (std::size_t k = 1; k < n; ++k) {
+        if (queues_[(self + k) % n]->pop_front(job)) {
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            execute(job);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::wait(JobCounter& counter) noexcept
+{
+    const std::size_t self = current_worker();
+    while (!counter.done()) {
+        if (!run_one(self)) std::this_thread::yield();
+    }
+}
+
+void JobSystem::worker_main(std::size_t index)
+{
+    t_owner = this;
+    t_worker = index;
+    while (running_.load(std::memory_order_acquire)) {
+        const uint32_t epoch = work_epoch_.load(std::memory_order_acquire);
+        if (run_one(index)) continue;
+        // Nothing to run anywhere: sleep until the next submit.
+        work_epoch_.wait(epoch, std::memory_order_acquire);
+    }
+}
+
+} // namespace ege
@@ -0,0 +1,61 @@
+#include <ege/engine/memory_registry.hpp>
+#include <cstdio>
+#include <mutex>
+
+namespace ege::memory {
+
+namespace {
+std::mutex g_mutex;
+MemoryEntry* g_head = nullptr;
+MemoryEntry* g_tail = nullptr;
+}
+
+void register_entry(MemoryEntry& entry) noexcept
+{
+    const std::lock_guard<std::mutex> lock(g_mutex);
+    entry.prev = g_tail;
+    entry.next = nullptr;
+    if (g_tail) g_tail->next = &entry;
+    else g_head = &entry;
+    g_tail = &entry;
+}
+
+void unregister_entry(MemoryEntry& entry) noexcept
+{
+    const std::lock_guard<std::mutex> lock(g_mutex);
+    if (entry.prev) entry.prev->next = entry.next;
+    else if (g_head == &entry) g_head = entry.next;
+    else return; // not registered
+    if (entry.next) entry.next->prev = entry.prev;
+    else g_tail = entry.prev;
+    entry.prev = entry.next = nullptr;
+}
+
+void for_each(void (*fn)(const char* name, const MemoryUsage& usage, void* ctx), void* ctx)
+{
+    const std::lock_guard<std::mutex> lock(g_mutex);
+    for (MemoryEntry* e = g_head; e != nullptr; e = e->next) fn(e->name, e->usage(e->owner), ctx);
+}
+
+std::string report()
+{
+    std::string out;
+    char line[192];
+    std::snprintf(line, sizeof(line), "%-28s %10s %10s %10s %6s %10s %8s %8s %s\n", "region", "capacity", "used",
+                  "peak", "peak%", "allocs", "failed", "wasted", "canary");
+    out += line;
+    for_each([&out, &line](const char* name, const MemoryUsage& u) {
+        const double peak_pct = u.block_size ? 100.0 * static_cast<double>(u.peak) / static_cast<double>(u.block_size) : 0.0;
+        char size[32];
+        if (u.blocks > 1) std::snprintf(size, sizeof(size), "%zux%zu", u.blocks, u.block_size);
+        else std::snprintf(size, sizeof(size), "%zu", u.block_size);
+        std::snprintf(line, sizeof(line), "%-28s %10s %10zu %10zu %5.1f%% %10llu %8llu %8zu %s\n",
+                      name ? name : "(unnamed)", size, u.used, u.peak, peak_pct,
+                      static_cast<unsigned long long>(u.allocations), static_cast<unsigned long long>(u.failed),
+                      u.wasted_alignment, u.canary_ok ? "ok" : "CORRUPT");
+        out += line;
+    });
+    return out;
+}
+
+} // namespace ege::memory
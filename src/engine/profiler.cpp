@@ -0,0 +1,200 @@
+#include "ege/engine/profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <new>
+#include <string_view>
+
+namespace ege::profile {
+
+namespace {
+
+// Fields are atomics so a reader snapshotting a ring while its owner keeps
+// recording never races; torn samples are detected and skipped instead.
+struct Sample {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> start{0};
+    std::atomic<uint64_t> end{0};
+};
+
+struct Ring {
+    std::array<Sample, kRingCapacity> samples;
+    std::atomic<uint64_t> head{0};  // samples ever written by the owner
+    std::atomic<uint64_t> floor{0}; // first sample not discarded by clear()
+    std::atomic<const char*> thread_name{nullptr};
+    uint32_t tid = 0;
+    Ring* next = nullptr;
+};
+
+struct Copied {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+};
+
+// Rings are never freed: a trace may be exported after its thread exited.
+std::atomic<Ring*> g_rings{nullptr};
+std::atomic<uint32_t> g_next_tid{1};
+std::atomic<uint64_t> g_dropped{0};
+thread_local Ring* t_ring = nullptr;
+thread_local bool t_ring_failed = false;
+
+// The calling thread's ring, allocated on first use; nullptr if that
+// allocation failed (it is not retried).
+Ring* local_ring() noexcept {
+    if (t_ring != nullptr || t_ring_failed) return t_ring;
+    auto* ring = new (std::nothrow) Ring;
+    if (ring == nullptr) {
+        t_ring_failed = true;
+        return nullptr;
+    }
+    ring->tid = g_next_tid.fetch_add(1, std::memory_order_relaxed);
+    ring->next = g_rings.load(std::memory_order_relaxed);
+    while (!g_rings.compare_exchange_weak(ring->next, ring, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    t_ring = ring;
+    return ring;
+}
+
+// Append the samples still valid in `ring` to `out`.
+void snapshot(const Ring& ring, std::vector<Copied>& out) {
+    const uint64_t head = ring.head.load(std::memory_order_acquire);
+    const uint64_t floor = ring.floor.load(std::memory_order_relaxed);
+    const uint64_t lo = std::max(floor, head > kRingCapacity ? head - kRingCapacity : 0);
+    const std::size_t first = out.size();
+    for (uint64_t i = lo; i < head; ++i) {
+        const Sample& s = ring.samples[i % kRingCapacity];
+        out.push_back(Copied{s.name.load(std::memory_order_relaxed), s.start.load(std::memory_order_relaxed),
+                             s.end.load(std::memory_order_relaxed)});
+    }
+    // Slots the owner reused while we copied hold a mix of two samples.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t now = ring.head.load(std::memory_order_relaxed);
+    const uint64_t valid_from = now >= kRingCapacity ? now - kRingCapacity + 1 : 0;
+    if (valid_from > lo) {
+        const auto torn = static_cast<std::size_t>(std::min(valid_from, head) - lo);
+        out.erase(out.begin() + static_cast<std::ptrdiff_t>(first),
+                  out.begin() + static_cast<std::ptrdiff_t>(first + torn));
+    }
+}
+
+void append_escaped(std::string& out, std::string_view s) {
+    for (const char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+}
+
+void append_us(std::string& out, uint64_t ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", static_cast<double>(ns) / 1000.0);
+    out += buf;
+}
+
+} // namespace
+
+uint64_t now_ns() noexcept {
+    using clock = std::chrono::steady_clock;
+    static const clock::time_point epoch = clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - epoch).count());
+}
+
+void record(const char* name, uint64_t start_ns, uint64_t end_ns) noexcept {
+    Ring* r = local_ring();
+    if (r == nullptr) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Ring& ring = *r;
+    const uint64_t h = ring.head.load(std::memory_order_relaxed);
+    Sample& s = ring.samples[h % kRingCapacity];
+    s.name.store(name, std::memory_order_relaxed);
+    s.start.store(start_ns, std::memory_order_relaxed);
+    s.end.store(end_ns, std::memory_order_relaxed);
+    ring.head.store(h + 1, std::memory_order_release);
+}
+
+bool prepare_thread() noexcept { return local_ring() != nullptr; }
+
+void set_thread_name(const char* name) noexcept {
+    if (Ring* ring = local_ring()) ring->thread_name.store(name, std::memory_order_relaxed);
+}
+
+uint64_t dropped_samples() noexcept { return g_dropped.load(std::memory_order_relaxed); }
+
+std::vector<PhaseStats> summary() {
+    std::vector<Copied> samples;
+    for (Ring* r = g_rings.load(std::memory_order_acquire); r != nullptr; r = r->next) snapshot(*r, samples);
+
+    // Group by name text: the same literal may have several addresses.
+    std::map<std::string_view, std::vector<uint64_t>> by_name;
+    for (const auto& s : samples) by_name[s.name].push_back(s.end - s.start);
+
+    std::vector<PhaseStats> out;
+    out.reserve(by_name.size());
+    for (auto& [name, durations] : by_name) {
+        std::sort(durations.begin(), durations.end());
+        uint64_t total = 0;
+        for (const uint64_t d : durations) total += d;
+        PhaseStats st;
+        st.name = name.data();
+        st.count = durations.size();
+        st.min_us = static_cast<double>(durations.front()) / 1000.0;
+        st.max_us = static_cast<double>(durations.back()) / 1000.0;
+        st.avg_us = static_cast<double>(total) / static_cast<double>(durations.size()) / 1000.0;
+        st.p99_us = static_cast<double>(durations[durations.size() * 99 / 100]) / 1000.0;
+        out.push_back(st);
+    }
+    return out;
+}
+
+std::string chrome_trace_json() {
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    std::vector<Copied> samples;
+    for (Ring* r = g_rings.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        const std::string tid = std::to_string(r->tid);
+        if (const char* thread = r->thread_name.load(std::memory_order_relaxed)) {
+            out += first ? "\n" : ",\n";
+            first = false;
+            out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":\"";
+            append_escaped(out, thread);
+            out += "\"}}";
+        }
+        samples.clear();
+        snapshot(*r, samples);
+        for (const auto& s : samples) {
+            out += first ? "\n" : ",\n";
+            first = false;
+            out += "{\"name\":\"";
+            append_escaped(out, s.name);
+            out += "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+            append_us(out, s.start);
+            out += ",\"dur\":";
+            append_us(out, s.end - s.start);
+            out += "}";
+        }
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool write_chrome_trace(const char* path) {
+    std::FILE* f = std::fopen(path, "wb");
+    if (f == nullptr) return false;
+    const std::string json = chrome_trace_json();
+    const bool ok = std::fwrite(json.data(), 1, json.size(), f) == json.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+void clear() noexcept {
+    for (Ring* r = g_rings.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        r->floor.store(r->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+} // namespace ege::profile
@@ -1,8 +1,13 @@
 #include <gtest/gtest.h>
 
 #include <ege/engine/allocator.hpp>
+#include <ege/engine/render_pipeline.hpp>
 #include <ege/engine/spsc_queue.hpp>
 
+#include <cstring>
+#include <memory>
+#include <string>
+
 TEST(StaticArenaTest, BasicAllocation) {
     alignas(16) char buf[256];
     ege::StaticArena arena(buf, sizeof(buf));
@@ -14,6 +19,101 @@ TEST(StaticArenaTest, BasicAllocation) {
     EXPECT_EQ(arena.used(), 0u);
 }
 
+TEST(StaticArenaTest, StatsSurviveReset) {
+    alignas(16) uint8_t buf[256];
+    ege::StaticArena arena(buf, sizeof(buf));
+    EXPECT_NE(arena.allocate(3, 1), nullptr);
+    EXPECT_NE(arena.allocate(16, 16), nullptr); // 13 bytes of padding
+    EXPECT_EQ(arena.used(), 32u);
+    EXPECT_EQ(arena.allocate(300), nullptr);
+    EXPECT_EQ(arena.allocations(), 2u);
+    EXPECT_EQ(arena.failed_allocations(), 1u);
+    EXPECT_EQ(arena.wasted_alignment(), 13u);
+
+    arena.reset();
+    EXPECT_NE(arena.allocate(8, 1), nullptr);
+    EXPECT_EQ(arena.used(), 8u);
+    EXPECT_EQ(arena.peak(), 32u);
+    EXPECT_EQ(arena.allocations(), 3u);
+
+    arena.clear_stats();
+    EXPECT_EQ(arena.peak(), 8u);
+    EXPECT_EQ(arena.allocations(), 0u);
+    EXPECT_EQ(arena.failed_allocations(), 0u);
+}
+
+TEST(StaticArenaTest, CanaryCatchesWritesPastAnAllocation) {
+    alignas(16) uint8_t buf[128];
+    ege::StaticArena arena(buf, sizeof(buf));
+    arena.enable_canary();
+    auto* p = static_cast<uint8_t*>(arena.allocate(16, 16));
+    ASSERT_NE(p, nullptr);
+    std::memset(p, 0, 16);
+    EXPECT_TRUE(arena.check_canary());
+
+    p[16] = 0; // one byte too far
+    EXPECT_FALSE(arena.check_canary());
+    EXPECT_NE(arena.allocate(16, 16), nullptr);
+    EXPECT_EQ(arena.canary_violations(), 1u);
+
+    arena.reset();
+    arena.clear_stats();
+    EXPECT_TRUE(arena.check_canary());
+}
+
+TEST(MemoryRegistryTest, ReportListsArenasBuffersAndPipelines) {
+    alignas(16) uint8_t buf[512];
+    auto pipeline = std::make_unique<ege::SPSCRenderPipeline<256, 3, 4>>();
+    const ege::TrackedMemory<ege::SPSCRenderPipeline<256, 3, 4>> tracked_pipeline("test.pipeline", *pipeline);
+    std::string report;
+    {
+        ege::StaticArena arena(buf, sizeof(buf), "test.arena");
+        (void)arena.allocate(100, 4);
+        (void)arena.allocate(1000);
+
+        ege::MemoryCommandBuffer<64> cmds;
+        const ege::TrackedMemory<ege::MemoryCommandBuffer<64>> tracked_cmds("test.cmds", cmds);
+        for (int i = 0; i < 10; ++i) cmds.push_rect(0, 1, 0, 0, 1, 1);
+        cmds.reset();
+
+        auto frame = pipeline->begin_frame();
+        ASSERT_TRUE(frame.has_value());
+        frame->get().push_clear(0);
+        pipeline->submit_frame();
+
+        bool seen_arena = false, seen_cmds = false, seen_pipeline = false;
+        ege::memory::for_each([&](const char* name, const ege::MemoryUsage& u) {
+            if (std::strcmp(name, "test.arena") == 0) {
+                seen_arena = true;
+                EXPECT_EQ(u.capacity(), 512u);
+                EXPECT_EQ(u.peak, 100u);
+                EXPECT_EQ(u.allocations, 1u);
+                EXPECT_EQ(u.failed, 1u);
+            } else if (std::strcmp(name, "test.cmds") == 0) {
+                seen_cmds = true;
+                EXPECT_EQ(u.used, 0u);
+                EXPECT_GT(u.peak, 0u);
+                EXPECT_GT(u.failed, 0u); // 10 rects do not fit in 64 bytes
+            } else if (std::strcmp(name, "test.pipeline") == 0) {
+                seen_pipeline = true;
+                EXPECT_EQ(u.blocks, 3u);
+                EXPECT_EQ(u.capacity(), 3u * 256u);
+                EXPECT_GT(u.used, 0u);
+            }
+        });
+        EXPECT_TRUE(seen_arena && seen_cmds && seen_pipeline);
+        report = ege::memory::report();
+    }
+    EXPECT_NE(report.find("test.arena"), std::string::npos);
+    EXPECT_NE(report.find("3x256"), std::string::npos);
+
+    // Destroyed regions leave the registry.
+    const std::string after = ege::memory::report();
+    EXPECT_EQ(after.find("test.arena"), std::string::npos);
+    EXPECT_EQ(after.find("test.cmds"), std::string::npos);
+    EXPECT_NE(after.find("test.pipeline"), std::string::npos);
+}
+
 TEST(SPSCQueueTest, PushPop) {
     ege::SPSCQueue<int, 8> q;
     for (int i = 0; i < 7; ++i) EXPECT_TRUE(q.push(i));
@@ -3,6 +3,10 @@
 #include <ege/engine/command_buffer.hpp>
 #include <ege/engine/render_command.hpp>
 
+#include <memory>
+#include <random>
+#include <vector>
+
 TEST(CommandBufferTest, EncodeDecode) {
     ege::MemoryCommandBuffer<256> buf;
     EXPECT_EQ(buf.size(), 0u);
@@ -21,3 +25,416 @@ TEST(CommandBufferTest, EncodeDecode) {
     EXPECT_EQ(out.commands[1].rect.x, 1);
     EXPECT_EQ(out.commands[2].rect.x, -5);
 }
+
+TEST(CommandBufferTest, ViewIteratesEncodedCommands) {
+    ege::MemoryCommandBuffer<256> buf;
+    buf.push_clear(0x11223344);
+    buf.push_rect(2, 0xFF, 1,2,3,4);
+    buf.push_rect(1, 0xAA, -5,-6,7,8);
+
+    ege::FrameBuffer<16> decoded;
+    buf.decode(decoded);
+
+    std::size_t i = 0;
+    for (const auto &cmd : buf.view()) {
+        ASSERT_LT(i, decoded.size());
+        EXPECT_EQ(cmd.type, decoded.commands[i].type);
+        EXPECT_EQ(cmd.layer, decoded.commands[i].layer);
+        EXPECT_EQ(cmd.color, decoded.commands[i].color);
+        EXPECT_EQ(cmd.rect.x, decoded.commands[i].rect.x);
+        EXPECT_EQ(cmd.rect.h, decoded.commands[i].rect.h);
+        ++i;
+    }
+    EXPECT_EQ(i, 3u);
+
+    int rects = 0;
+    auto visited = buf.for_each([&rects](const ege::RenderCommand &cmd) {
+        if (cmd.type == ege::RenderCommandType::Rect) ++rects;
+    });
+    EXPECT_EQ(visited, 3u);
+    EXPECT_EQ(rects, 2);
+}
+
+TEST(CommandBufferTest, ViewStopsAtTruncatedCommand) {
+    ege::MemoryCommandBuffer<256> buf;
+    buf.push_clear(0x1);
+    buf.push_rect(0, 0x2, 0,0,1,1);
+    // Drop the last byte of the rect: only the clear is well-formed.
+    ege::CommandView truncated(buf.view().data(), buf.size() - 1);
+    std::size_t n = 0;
+    for (const auto &cmd : truncated) { (void)cmd; ++n; }
+    EXPECT_EQ(n, 1u);
+    EXPECT_TRUE(ege::CommandView{}.begin() == ege::CommandView{}.end());
+}
+
+TEST(CommandBufferTest, SpriteRoundTrip) {
+    ege::MemoryCommandBuffer<256> buf;
+    buf.push_sprite(3, 7, ege::SpriteFrame{16, 32, 8, 12}, -4, 100, ege::SpriteFlipX | ege::SpriteFlipY);
+    EXPECT_EQ(buf.size(), 16u);
+
+    ege::FrameBuffer<4> out;
+    ASSERT_EQ(buf.decode(out), 1u);
+    const auto &cmd = out.commands[0];
+    EXPECT_EQ(cmd.type, ege::RenderCommandType::Sprite);
+    EXPECT_EQ(cmd.layer, 3u);
+    EXPECT_EQ(cmd.sprite.atlas, 7u);
+    EXPECT_EQ(cmd.sprite.flags, ege::SpriteFlipX | ege::SpriteFlipY);
+    EXPECT_EQ(cmd.sprite.sx, 16);
+    EXPECT_EQ(cmd.sprite.sy, 32);
+    EXPECT_EQ(cmd.rect.w, 8);
+    EXPECT_EQ(cmd.rect.h, 12);
+    EXPECT_EQ(cmd.rect.x, -4);
+    EXPECT_EQ(cmd.rect.y, 100);
+}
+
+namespace {
+
+// Grid of tiles in a handful of colours, like a UI or tile map.
+template<std::size_t N>
+std::size_t record_grid(ege::MemoryCommandBuffer<N> &buf, std::size_t count) {
+    buf.push_clear(0xFF000000);
+    std::size_t pushed = 0;
+    for (int16_t y = 0; y < 240 && pushed < count; y = static_cast<int16_t>(y + 16)) {
+        for (int16_t x = 0; x < 320 && pushed < count; x = static_cast<int16_t>(x + 16), ++pushed) {
+            buf.push_rect(static_cast<uint8_t>(y / 80), 0xFF000000u | static_cast<uint32_t>((x / 64) * 0x203040), x, y, 15, 15);
+        }
+    }
+    return pushed;
+}
+
+} // namespace
+
+TEST(CommandBufferTest, CompactRoundTripMatchesFixed) {
+    std::mt19937 rng(5u);
+    std::uniform_int_distribution<int> coord(-32768, 32767);
+    std::uniform_int_distribution<int> small(-40, 400);
+    std::uniform_int_distribution<uint32_t> color;
+    ege::MemoryCommandBuffer<8192> fixed, compact;
+    compact.set_encoding(ege::CommandEncoding::Compact);
+    for (int i = 0; i < 200; ++i) {
+        // Mix of extreme and typical values so every varint length is hit.
+        auto pick = [&](bool wide) { return static_cast<int16_t>(wide ? coord(rng) : small(rng)); };
+        const bool wide = i % 5 == 0;
+        const auto layer = static_cast<uint8_t>(i / 50);
+        const uint32_t c = i % 3 == 0 ? color(rng) : 0xFF112233u;
+        for (auto *b : {&fixed, &compact}) {
+            if (i == 100) b->push_clear(0xFF445566);
+            if (i == 150) b->push_sprite(2, 1, ege::SpriteFrame{0, 0, 8, 8}, -3, 7);
+        }
+        const int16_t x = pick(wide), y = pick(wide), w = pick(wide), h = pick(wide);
+        fixed.push_rect(layer, c, x, y, w, h);
+        compact.push_rect(layer, c, x, y, w, h);
+    }
+    ege::FrameBuffer<256> a, b;
+    ASSERT_EQ(fixed.decode(a), 202u);
+    ASSERT_EQ(compact.decode(b), 202u);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a.commands[i].type, b.commands[i].type) << i;
+        EXPECT_EQ(a.commands[i].layer, b.commands[i].layer) << i;
+        EXPECT_EQ(a.commands[i].color, b.commands[i].color) << i;
+        EXPECT_EQ(a.commands[i].rect.x, b.commands[i].rect.x) << i;
+        EXPECT_EQ(a.commands[i].rect.y, b.commands[i].rect.y) << i;
+        EXPECT_EQ(a.commands[i].rect.w, b.commands[i].rect.w) << i;
+        EXPECT_EQ(a.commands[i].rect.h, b.commands[i].rect.h) << i;
+        EXPECT_EQ(a.commands[i].sprite.atlas, b.commands[i].sprite.atlas) << i;
+    }
+    EXPECT_LT(compact.size(), fixed.size());
+}
+
+TEST(CommandBufferTest, CompactFitsMoreRectsPerBuffer) {
+    ege::MemoryCommandBuffer<1024> fixed, compact;
+    compact.set_encoding(ege::CommandEncoding::Compact);
+    // 72 rects + clear fill the fixed buffer; the compact one takes them all
+    // in under half the space.
+    record_grid(fixed, 72);
+    record_grid(compact, 72);
+    EXPECT_GT(fixed.size(), 1000u);
+    EXPECT_LT(compact.size() * 2, fixed.size());
+    EXPECT_EQ(compact.view().for_each([](const ege::RenderCommand &) {}), 73u);
+
+    // The encoding survives reset; an empty compact buffer has no bytes.
+    compact.reset();
+    EXPECT_EQ(compact.size(), 0u);
+    EXPECT_EQ(compact.encoding(), ege::CommandEncoding::Compact);
+    EXPECT_EQ(record_grid(compact, 144), 144u); // twice the fixed limit
+    EXPECT_LE(compact.size(), compact.capacity());
+}
+
+TEST(CommandBufferTest, CompactStreamVersionTagging) {
+    ege::MemoryCommandBuffer<256> compact;
+    compact.set_encoding(ege::CommandEncoding::Compact);
+    compact.push_rect(1, 0xFF00FF00, 10, 20, 30, 40);
+    ASSERT_GE(compact.size(), 2u);
+    EXPECT_EQ(compact.view().data()[0], 0x10u);
+
+    // Unknown versions stop decoding instead of misreading the stream.
+    std::vector<uint8_t> bytes(compact.view().data(), compact.view().data() + compact.size());
+    bytes[1] = 9;
+    EXPECT_EQ(ege::CommandView(bytes.data(), bytes.size()).for_each([](const ege::RenderCommand &) {}), 0u);
+
+    // Compact opcodes are rejected in an untagged (fixed) stream.
+    EXPECT_EQ(ege::CommandView(compact.view().data() + 2, compact.size() - 2).for_each([](const ege::RenderCommand &) {}), 0u);
+
+    // Truncated compact rect.
+    EXPECT_EQ(ege::CommandView(compact.view().data(), compact.size() - 1).for_each([](const ege::RenderCommand &) {}), 0u);
+}
+
+TEST(CommandBufferTest, RectBatchIsOneCommandAndExpandsOnDecode) {
+    const ege::RectInstance rects[] = {{1, 2, 3, 4}, {-5, 6, 7, 8}, {100, -200, 1, 1}};
+    for (auto encoding : {ege::CommandEncoding::Fixed, ege::CommandEncoding::Compact}) {
+        ege::MemoryCommandBuffer<256> buf;
+        buf.set_encoding(encoding);
+        buf.push_clear(0x1);
+        buf.push_rect_batch(4, 0xFF00FF00, rects);
+        buf.push_rect_batch(4, 0xFF00FF00, {});
+        buf.push_rect(1, 0x2, 9, 9, 9, 9);
+
+        std::size_t n = 0;
+        for (const auto &cmd : buf.view()) {
+            if (n == 1) {
+                ASSERT_EQ(cmd.type, ege::RenderCommandType::RectBatch);
+                EXPECT_EQ(cmd.layer, 4u);
+                EXPECT_EQ(cmd.color, 0xFF00FF00u);
+                ASSERT_EQ(cmd.batch.count, 3u);
+                EXPECT_EQ(cmd.rect_instance(1).x, -5);
+                EXPECT_EQ(cmd.rect_instance(2).y, -200);
+            }
+            ++n;
+        }
+        EXPECT_EQ(n, 4u);
+
+        ege::FrameBuffer<16> out;
+        ASSERT_EQ(buf.decode(out), 5u);
+        EXPECT_EQ(out.commands[1].type, ege::RenderCommandType::Rect);
+        EXPECT_EQ(out.commands[2].rect.w, 7);
+        EXPECT_EQ(out.commands[3].layer, 4u);
+        EXPECT_EQ(out.commands[3].color, 0xFF00FF00u);
+        EXPECT_EQ(out.commands[4].rect.x, 9);
+    }
+    // Header plus 8 bytes per instance.
+    ege::MemoryCommandBuffer<256> fixed;
+    fixed.push_rect_batch(0, 0, rects);
+    EXPECT_EQ(fixed.size(), 8u + 3u * 8u);
+    // A batch cut short stops decoding.
+    EXPECT_EQ(ege::CommandView(fixed.view().data(), fixed.size() - 1).for_each([](const ege::RenderCommand &) {}), 0u);
+}
+
+TEST(CommandBufferTest, OversizedRectBatchIsSplit) {
+    std::vector<ege::RectInstance> rects(70000);
+    for (std::size_t i = 0; i < rects.size(); ++i) rects[i] = {static_cast<int16_t>(i % 1000), 1, 2, 2};
+    auto buf = std::make_unique<ege::MemoryCommandBuffer<600 * 1024>>();
+    buf->push_rect_batch(2, 0xFF00FF00, rects);
+    buf->push_rect(3, 0x1, 7, 7, 7, 7);
+    EXPECT_EQ(buf->dropped_commands(), 0u);
+
+    std::vector<std::size_t> counts;
+    std::size_t instances = 0;
+    const std::size_t n = buf->for_each([&](const ege::RenderCommand &cmd) {
+        if (cmd.type != ege::RenderCommandType::RectBatch) return;
+        counts.push_back(cmd.batch.count);
+        instances += cmd.batch.count;
+        EXPECT_EQ(cmd.rect_instance(cmd.batch.count - 1).x,
+                  static_cast<int16_t>((instances - 1) % 1000));
+    });
+    EXPECT_EQ(n, 3u); // two batches plus the trailing rect
+    ASSERT_EQ(counts.size(), 2u);
+    EXPECT_EQ(counts[0], 65535u);
+    EXPECT_EQ(instances, rects.size());
+}
+
+TEST(CommandBufferTest, FullBufferDropsInsteadOfOverflowing) {
+    ege::MemoryCommandBuffer<33> buf;
+    buf.push_rect(0, 1, 0, 0, 1, 1);
+    buf.push_rect(0, 2, 0, 0, 1, 1);
+    buf.push_rect(0, 3, 0, 0, 1, 1); // 42 bytes > 33
+    buf.push_clear(4);               // 28 + 5 still fits
+    EXPECT_EQ(buf.size(), 33u);
+    EXPECT_EQ(buf.dropped_commands(), 1u);
+    EXPECT_EQ(buf.for_each([](const ege::RenderCommand &) {}), 3u);
+    buf.reset();
+    EXPECT_EQ(buf.dropped_commands(), 0u);
+
+    ege::FrameBuffer<2> frame;
+    EXPECT_TRUE(frame.push({}));
+    EXPECT_TRUE(frame.push({}));
+    EXPECT_FALSE(frame.push({}));
+    EXPECT_EQ(frame.size(), 2u);
+    EXPECT_EQ(frame.dropped, 1u);
+}
+
+TEST(CommandBufferTest, OverflowChunksDecodeSeamlessly) {
+    alignas(std::max_align_t) static uint8_t storage[8192];
+    for (auto encoding : {ege::CommandEncoding::Fixed, ege::CommandEncoding::Compact}) {
+        ege::StaticArena arena(storage, sizeof(storage));
+        ege::MemoryCommandBuffer<64> buf;
+        buf.set_overflow_arena(&arena, 128);
+        buf.set_encoding(encoding);
+        ege::MemoryCommandBuffer<8192> flat;
+        flat.set_encoding(encoding);
+        const ege::RectInstance batch[] = {{1, 1, 2, 2}, {3, 3, 4, 4}};
+        for (int i = 0; i < 200; ++i) {
+            const auto layer = static_cast<uint8_t>(i / 40);
+            const uint32_t color = 0xFF000000u | static_cast<uint32_t>(i / 7);
+            const auto x = static_cast<int16_t>(i * 3 - 100);
+            buf.push_rect(layer, color, x, 5, 6, 7);
+            flat.push_rect(layer, color, x, 5, 6, 7);
+            if (i % 50 == 0) {
+                buf.push_rect_batch(layer, color, batch);
+                flat.push_rect_batch(layer, color, batch);
+                buf.push_sprite(layer, 1, ege::SpriteFrame{0, 0, 8, 8}, x, 9);
+                flat.push_sprite(layer, 1, ege::SpriteFrame{0, 0, 8, 8}, x, 9);
+            }
+        }
+        EXPECT_EQ(buf.dropped_commands(), 0u);
+        EXPECT_GT(buf.chunk_count(), 2u);
+        EXPECT_EQ(buf.size(), flat.size());
+
+        ege::FrameBuffer<256> a, b;
+        ASSERT_EQ(buf.decode(a), flat.decode(b));
+        EXPECT_EQ(a.size(), 212u);
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            EXPECT_EQ(a.commands[i].type, b.commands[i].type) << i;
+            EXPECT_EQ(a.commands[i].layer, b.commands[i].layer) << i;
+            EXPECT_EQ(a.commands[i].color, b.commands[i].color) << i;
+            EXPECT_EQ(a.commands[i].rect.x, b.commands[i].rect.x) << i;
+            EXPECT_EQ(a.commands[i].rect.w, b.commands[i].rect.w) << i;
+        }
+        std::size_t n = 0;
+        for (const auto &cmd : buf.view()) { (void)cmd; ++n; }
+        EXPECT_EQ(n, 208u); // batches stay single commands
+
+        // reset() hands the chunks back to the arena.
+        buf.reset();
+        EXPECT_EQ(arena.used(), 0u);
+        EXPECT_EQ(buf.chunk_count(), 0u);
+        EXPECT_TRUE(buf.view().empty());
+    }
+}
+
+TEST(CommandBufferTest, DropLowestLayerKeepsReserveForUpperLayers) {
+    alignas(std::max_align_t) static uint8_t storage[1024];
+    ege::StaticArena arena(storage, sizeof(storage));
+    ege::MemoryCommandBuffer<64> buf;
+    buf.set_overflow_arena(&arena, 64, ege::OverflowPolicy::DropLowestLayer, 256);
+
+    // Background detail on layer 0 fills everything but the reserve...
+    for (int i = 0; i < 100; ++i) buf.push_rect(0, 1, static_cast<int16_t>(i), 0, 1, 1);
+    const std::size_t dropped = buf.dropped_commands();
+    EXPECT_GT(dropped, 0u);
+    EXPECT_LE(arena.used() + 256, arena.capacity());
+
+    // ...so the HUD on layer 3 still fits.
+    for (int i = 0; i < 12; ++i) buf.push_rect(3, 2, static_cast<int16_t>(i), 0, 1, 1);
+    EXPECT_EQ(buf.dropped_commands(), dropped);
+    int hud = 0;
+    buf.for_each([&hud](const ege::RenderCommand &cmd) { hud += cmd.layer == 3; });
+    EXPECT_EQ(hud, 12);
+
+    // With DropNewest the background takes the whole arena instead.
+    buf.set_overflow_arena(&arena, 64, ege::OverflowPolicy::DropNewest);
+    for (int i = 0; i < 100; ++i) buf.push_rect(0, 1, static_cast<int16_t>(i), 0, 1, 1);
+    const std::size_t before = buf.dropped_commands();
+    buf.push_rect(3, 2, 0, 0, 1, 1);
+    EXPECT_EQ(buf.dropped_commands(), before + 1);
+}
+
+TEST(CommandBufferTest, DropLowestLayerKeepsHudRecordedFirst) {
+    alignas(std::max_align_t) static uint8_t storage[1024];
+    ege::StaticArena arena(storage, sizeof(storage));
+    ege::MemoryCommandBuffer<64> buf;
+    // Almost the whole arena is reserved for layers 3 and up.
+    buf.set_overflow_arena(&arena, 64, ege::OverflowPolicy::DropLowestLayer, 900, 3);
+
+    // The HUD is recorded before anything else and spills into the reserve...
+    for (int i = 0; i < 20; ++i) buf.push_rect(3, 2, static_cast<int16_t>(i), 0, 1, 1);
+    EXPECT_EQ(buf.dropped_commands(), 0u);
+    EXPECT_GT(buf.chunk_count(), 0u);
+
+    // ...while the world below the floor is shed once the reserve is reached.
+    for (int i = 0; i < 100; ++i) buf.push_rect(static_cast<uint8_t>(i % 3), 1, static_cast<int16_t>(i), 0, 1, 1);
+    EXPECT_GT(buf.dropped_commands(), 0u);
+    const std::size_t dropped = buf.dropped_commands();
+    for (int i = 0; i < 4; ++i) buf.push_rect(4, 2, static_cast<int16_t>(i), 0, 1, 1);
+    EXPECT_EQ(buf.dropped_commands(), dropped);
+    int hud = 0;
+    buf.for_each([&hud](const ege::RenderCommand &cmd) { hud += cmd.layer >= 3; });
+    EXPECT_EQ(hud, 24);
+}
+
+TEST(CommandBufferTest, ViewportCullsAndTrimsAtRecordTime) {
+    ege::MemoryCommandBuffer<1024> buf;
+    buf.set_viewport({0, 0, 100, 50});
+
+    buf.push_rect(0, 1, 10, 10, 20, 20);   // inside: kept as is
+    buf.push_rect(0, 2, 90, 40, 20, 20);   // straddles the corner: trimmed
+    buf.push_rect(0, 3, 200, 10, 20, 20);  // right of the viewport: culled
+    buf.push_rect(0, 4, -30, 10, 30, 20);  // touches x = 0 from the left: culled
+    buf.push_sprite(0, 0, ege::SpriteFrame{0, 0, 16, 16}, -8, -8);  // partly visible: kept
+    buf.push_sprite(0, 0, ege::SpriteFrame{0, 0, 16, 16}, 10, 60);  // below: culled
+    EXPECT_EQ(buf.culled_commands(), 3u);
+    EXPECT_EQ(buf.trimmed_commands(), 1u);
+
+    const ege::RectInstance rects[] = {{0, 0, 5, 5}, {500, 0, 5, 5}, {40, 40, 5, 5}, {0, -10, 5, 5}};
+    buf.push_rect_batch(1, 5, rects);
+    const std::size_t before = buf.size();
+    const ege::RectInstance hidden[] = {{-50, 0, 5, 5}, {0, 90, 5, 5}};
+    buf.push_rect_batch(1, 6, hidden);
+    EXPECT_EQ(buf.size(), before); // nothing visible, nothing recorded
+    EXPECT_EQ(buf.culled_commands(), 7u);
+
+    std::vector<ege::RenderCommand> cmds;
+    buf.for_each([&cmds](const ege::RenderCommand &cmd) { cmds.push_back(cmd); });
+    ASSERT_EQ(cmds.size(), 4u);
+    EXPECT_EQ(cmds[1].rect.x, 90);
+    EXPECT_EQ(cmds[1].rect.w, 10);
+    EXPECT_EQ(cmds[1].rect.h, 10);
+    ASSERT_EQ(cmds[3].type, ege::RenderCommandType::RectBatch);
+    ASSERT_EQ(cmds[3].batch.count, 2u);
+    EXPECT_EQ(cmds[3].rect_instance(1).x, 40);
+
+    // The viewport survives reset; the counters do not.
+    buf.reset();
+    EXPECT_TRUE(buf.has_viewport());
+    EXPECT_EQ(buf.culled_commands(), 0u);
+    buf.clear_viewport();
+    buf.push_rect(0, 3, 200, 10, 20, 20);
+    EXPECT_EQ(buf.culled_commands(), 0u);
+    EXPECT_FALSE(buf.view().empty());
+}
+
+TEST(CommandBufferTest, CompactFrameWhoseFirstCommandOverflowsStillDecodes) {
+    alignas(std::max_align_t) static uint8_t storage[8192];
+    std::vector<ege::RectInstance> rects(200);
+    for (std::size_t i = 0; i < rects.size(); ++i) rects[i] = {static_cast<int16_t>(i), 0, 2, 2};
+
+    for (const auto encoding : {ege::CommandEncoding::Fixed, ege::CommandEncoding::Compact}) {
+        ege::StaticArena arena(storage, sizeof(storage));
+        ege::MemoryCommandBuffer<1024> buf;
+        buf.set_overflow_arena(&arena);
+        buf.set_encoding(encoding);
+        buf.push_rect_batch(0, 1, rects); // 1608 bytes: straight into a chunk
+        buf.push_rect(0, 2, 5, 5, 10, 10);
+        EXPECT_EQ(buf.dropped_commands(), 0u);
+        EXPECT_GE(buf.chunk_count(), 1u);
+
+        std::vector<ege::RenderCommand> cmds;
+        buf.view().for_each([&cmds](const ege::RenderCommand &cmd) { cmds.push_back(cmd); });
+        ASSERT_EQ(cmds.size(), 2u) << static_cast<int>(encoding);
+        EXPECT_EQ(cmds[0].type, ege::RenderCommandType::RectBatch);
+        EXPECT_EQ(cmds[1].rect.w, 10);
+        std::size_t iterated = 0;
+        for (const auto &cmd : buf.view()) { (void)cmd; ++iterated; }
+        EXPECT_EQ(iterated, 2u);
+    }
+}
+
+TEST(CommandBufferTest, StateOnlySegmentDecodesAsEmpty) {
+    // A Version tag with nothing after it ends the segment cleanly.
+    const uint8_t tag_only[] = {0x10, static_cast<uint8_t>(ege::CommandEncoding::Compact)};
+    const uint8_t* p = tag_only;
+    ege::RenderCommand cmd{};
+    ege::detail::StreamState state{};
+    EXPECT_FALSE(ege::detail::decode_command(p, tag_only + sizeof(tag_only), cmd, state));
+    EXPECT_EQ(p, tag_only + sizeof(tag_only));
+    EXPECT_EQ(state.encoding, ege::CommandEncoding::Compact);
+}
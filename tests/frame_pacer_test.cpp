@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <ege/engine/frame_pacer.hpp>
+
+using namespace std::chrono_literals;
+using Clock = ege::FramePacer::Clock;
+
+namespace {
+
+ege::FramePacerConfig config_60hz() {
+    ege::FramePacerConfig c;
+    c.update_hz = 60.0;
+    c.target_fps = 0.0;
+    c.max_updates_per_frame = 4;
+    return c;
+}
+
+} // namespace
+
+TEST(FramePacerTest, AccumulatesRealTimeIntoFixedSteps) {
+    ege::FramePacer pacer(config_60hz());
+    const Clock::time_point t0{};
+    pacer.reset(t0);
+
+    // 10 ms < one 16.67 ms step: nothing to simulate yet, alpha ~0.6.
+    EXPECT_EQ(pacer.begin_frame(t0 + 10ms), 0);
+    EXPECT_NEAR(pacer.alpha(), 0.6f, 1e-3f);
+
+    // +10 ms: 20 ms accumulated -> one step, 3.33 ms left over.
+    EXPECT_EQ(pacer.begin_frame(t0 + 20ms), 1);
+    EXPECT_NEAR(pacer.alpha(), 0.2f, 1e-3f);
+
+    // +30 ms: 33.3 ms accumulated -> two steps.
+    EXPECT_EQ(pacer.begin_frame(t0 + 50ms), 2);
+    EXPECT_NEAR(pacer.step_seconds(), 1.0f / 60.0f, 1e-7f);
+}
+
+TEST(FramePacerTest, SimulatedTimeTracksWallClockAcrossUnevenFrames) {
+    ege::FramePacer pacer(config_60hz());
+    const Clock::time_point t0{};
+    pacer.reset(t0);
+    const std::chrono::milliseconds frames[] = {5ms, 23ms, 16ms, 17ms, 2ms, 31ms, 9ms, 16ms};
+    Clock::time_point t = t0;
+    int steps = 0;
+    for (auto d : frames) {
+        t += d;
+        steps += pacer.begin_frame(t);
+    }
+    // 119 ms total = 7 whole steps + 2.33 ms.
+    EXPECT_EQ(steps, 7);
+    EXPECT_NEAR(pacer.alpha(), 0.14f, 1e-3f);
+}
+
+TEST(FramePacerTest, CatchUpIsBoundedAfterStall) {
+    ege::FramePacer pacer(config_60hz());
+    const Clock::time_point t0{};
+    pacer.reset(t0);
+    // A one second hitch would need 60 steps; only 4 run, the rest are dropped.
+    EXPECT_EQ(pacer.begin_frame(t0 + 1000ms), 4);
+    EXPECT_EQ(pacer.stats().dropped_steps, 56u);
+    EXPECT_LT(pacer.alpha(), 1.0f);
+    // Next normal frame is back to one step.
+    EXPECT_EQ(pacer.begin_frame(t0 + 1000ms + 17ms), 1);
+}
+
+TEST(FramePacerTest, ReportsFrameJitter) {
+    ege::FramePacer pacer(config_60hz());
+    Clock::time_point t{};
+    pacer.reset(t);
+    for (int i = 0; i < 4; ++i) {
+        t += (i % 2 == 0) ? 10ms : 20ms;
+        (void)pacer.begin_frame(t);
+    }
+    const auto &s = pacer.stats();
+    EXPECT_EQ(s.frames, 4u);
+    EXPECT_NEAR(s.mean_ms, 15.0, 1e-9);
+    EXPECT_NEAR(s.min_ms, 10.0, 1e-9);
+    EXPECT_NEAR(s.max_ms, 20.0, 1e-9);
+    EXPECT_NEAR(s.jitter_ms, 5.0, 1e-9);
+    EXPECT_NEAR(s.last_ms, 20.0, 1e-9);
+}
+
+TEST(FramePacerTest, WaitHoldsTargetFrameRate) {
+    ege::FramePacerConfig c;
+    c.target_fps = 200.0; // 5 ms frames
+    ege::FramePacer pacer(c);
+    const auto start = Clock::now();
+    pacer.reset(start);
+    for (int i = 0; i < 10; ++i) pacer.wait_for_next_frame();
+    const auto elapsed = Clock::now() - start;
+    // Spinning lands on the deadline; never early.
+    EXPECT_GE(elapsed, 50ms);
+    EXPECT_LT(elapsed, 500ms);
+}
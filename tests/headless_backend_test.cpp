@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <ege/backend.hpp>
+#include <ege/backends/headless/headless_backend.hpp>
+#include <ege/runtime.hpp>
+
+static_assert(ege::backend::BackendConcept<ege::backend::HeadlessBackend>);
+
+namespace {
+
+ege::Event right_click(int32_t x, int32_t y) {
+    ege::Event e{};
+    e.type = ege::EventType::Input;
+    e.id = 3; // right mouse button (id 1 doubles as InputCode::Quit)
+    e.payload.i = 1;
+    e.pos = {x, y};
+    return e;
+}
+
+// Draws a clear and a cursor square that jumps to each right click.
+struct CursorLayer : ege::Layer {
+    int16_t x = 0, y = 0;
+    int clicks = 0;
+    int last_click_frame = -1;
+    int frame = 0;
+    bool on_event(const ege::Event& e) override {
+        if (!e.is_right_click()) return false;
+        x = static_cast<int16_t>(e.pos.x);
+        y = static_cast<int16_t>(e.pos.y);
+        ++clicks;
+        last_click_frame = frame;
+        return true;
+    }
+    void on_render(int frame_count) override {
+        frame = frame_count + 1;
+        cmdbuf_->push_clear(0xFF102030);
+        cmdbuf_->push_rect(0, 0xFFFFAA00, 8, 8, 40, 24);
+        cmdbuf_->push_rect(1, 0xFFFFFFFF, x, y, 6, 6);
+    }
+};
+
+// The golden scene: opaque panels over a clear and a batch, on three layers.
+// Kept opaque so the hash does not depend on which blend kernel runs.
+void record_golden(ege::MemoryCommandBuffer<1024>& buf) {
+    buf.push_clear(0xFF001144);
+    buf.push_rect(0, 0xFFFFAA00, 10, 10, 50, 30);
+    buf.push_rect(1, 0xFF40C040, 40, 20, 60, 60);
+    buf.push_rect(0, 0xFFC0C0C0, 70, 5, 40, 90);
+    const ege::RectInstance dots[] = {{2, 90, 4, 4}, {12, 90, 4, 4}, {22, 90, 4, 4}};
+    buf.push_rect_batch(2, 0xFFFF00FF, dots);
+}
+
+} // namespace
+
+TEST(HeadlessBackendTest, GoldenFrameHash) {
+    ege::backend::HeadlessBackend backend;
+    ASSERT_TRUE(backend.init(128, 96));
+    ege::MemoryCommandBuffer<1024> buf;
+    record_golden(buf);
+    backend.present(buf.view());
+
+    EXPECT_EQ(backend.pixel(0, 0), 0xFF001144u);
+    EXPECT_EQ(backend.pixel(75, 30), 0xFF40C040u); // layer 1 over layer 0
+    EXPECT_EQ(backend.pixel(13, 91), 0xFFFF00FFu);
+    EXPECT_EQ(backend.framebuffer_hash(), 0x2fd595ef39f66925ull);
+}
+
+TEST(HeadlessBackendTest, IncrementalFramesHashLikeFullFrames) {
+    ege::backend::HeadlessBackend fresh, reused;
+    ASSERT_TRUE(fresh.init(128, 96));
+    ASSERT_TRUE(reused.init(128, 96));
+    ege::MemoryCommandBuffer<1024> buf;
+
+    buf.push_clear(0xFF000000);
+    buf.push_rect(0, 0xFFFFFFFF, 30, 30, 64, 40);
+    reused.present(buf.view());
+    const uint64_t first = reused.framebuffer_hash();
+
+    buf.reset();
+    record_golden(buf);
+    reused.present(buf.view());
+    fresh.present(buf.view());
+    EXPECT_NE(reused.framebuffer_hash(), first);
+    EXPECT_EQ(reused.framebuffer_hash(), fresh.framebuffer_hash());
+}
+
+TEST(HeadlessBackendTest, ScriptedInputDrivesTheRuntime) {
+    ege::backend::HeadlessBackend backend;
+    ASSERT_TRUE(backend.init(64, 64));
+    std::array<uint64_t, 16> hashes{};
+    backend.set_frame_log(hashes);
+    backend.script(3, right_click(20, 30));
+    backend.script(6, right_click(40, 10));
+    backend.quit_at(9);
+
+    ege::SPSCRenderPipeline<1024, 4, 8> pipeline;
+    ege::PhysicsSystem physics;
+    ege::RuntimeConfig config;
+    config.pacing.target_fps = 0.0;
+    ege::Runtime rt(backend, pipeline, physics, config);
+    CursorLayer layer;
+    layer.show();
+    rt.push_layer(&layer);
+    rt.run();
+
+    EXPECT_EQ(backend.frames_polled(), 10u);
+    EXPECT_EQ(layer.clicks, 2);
+    EXPECT_EQ(layer.last_click_frame, 6);
+    EXPECT_EQ(layer.x, 40);
+    EXPECT_EQ(backend.pixel(42, 12), 0xFFFFFFFFu);
+    ASSERT_GE(backend.frames_presented(), 8u);
+    // The screen only changes on the frames a click moved the cursor.
+    EXPECT_EQ(hashes[1], hashes[2]);
+    EXPECT_NE(hashes[2], hashes[3]);
+    EXPECT_EQ(hashes[3], hashes[5]);
+    EXPECT_NE(hashes[5], hashes[6]);
+    EXPECT_EQ(hashes[backend.frames_presented() - 1], backend.framebuffer_hash());
+}
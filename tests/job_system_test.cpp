@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <ege/engine/job_system.hpp>
+#include <ege/runtime.hpp>
+
+TEST(JobSystemTest, ParallelForVisitsEveryIndexOnce) {
+    ege::JobSystem jobs(4);
+    EXPECT_EQ(jobs.worker_count(), 4u);
+    std::vector<std::atomic<int>> hits(10007);
+    jobs.parallel_for(hits.size(), [&hits](std::size_t i) { hits[i].fetch_add(1, std::memory_order_relaxed); });
+    for (std::size_t i = 0; i < hits.size(); ++i) ASSERT_EQ(hits[i].load(), 1) << i;
+}
+
+TEST(JobSystemTest, OverflowingTheQueueRunsInline) {
+    ege::JobSystem jobs(2);
+    std::atomic<uint32_t> sum{0};
+    ege::JobCounter counter;
+    const std::size_t n = ege::JobSystem::kQueueCapacity * 3;
+    for (std::size_t i = 0; i < n; ++i) {
+        jobs.submit([](void* data, std::size_t b, std::size_t e) {
+            static_cast<std::atomic<uint32_t>*>(data)->fetch_add(static_cast<uint32_t>(e - b));
+        }, &sum, i, i + 2, counter);
+    }
+    jobs.wait(counter);
+    EXPECT_TRUE(counter.done());
+    EXPECT_EQ(sum.load(), 2u * n);
+}
+
+TEST(JobSystemTest, JobsCanSubmitAndWaitOnNestedWork) {
+    ege::JobSystem jobs(3);
+    struct Ctx { ege::JobSystem* jobs; std::atomic<int> leaves{0}; } ctx{&jobs};
+    ege::JobCounter outer;
+    for (int i = 0; i < 16; ++i) {
+        jobs.submit([](void* data, std::size_t, std::size_t) {
+            auto* c = static_cast<Ctx*>(data);
+            ege::JobCounter inner;
+            for (int k = 0; k < 8; ++k) {
+                c->jobs->submit([](void* d, std::size_t, std::size_t) {
+                    static_cast<Ctx*>(d)->leaves.fetch_add(1);
+                }, c, 0, 1, inner);
+            }
+            c->jobs->wait(inner); // dependency: this job finishes after its children
+        }, &ctx, 0, 1, outer);
+    }
+    jobs.wait(outer);
+    EXPECT_EQ(ctx.leaves.load(), 16 * 8);
+}
+
+TEST(JobSystemTest, SubmitAfterStartsJobsOnceTheirDependencyIsDone) {
+    ege::JobSystem jobs(4);
+    // Three stages: 64 producers, then 8 jobs that need all of them, then one
+    // job that needs those 8. Nothing blocks between submissions.
+    struct Ctx {
+        std::atomic<int> produced{0};
+        std::atomic<int> consumed{0};
+        std::atomic<int> early{0};
+        std::atomic<int> final_seen{-1};
+    };
+    for (int round = 0; round < 50; ++round) {
+        Ctx ctx;
+        ege::JobCounter stage1, stage2, stage3;
+        for (int i = 0; i < 64; ++i) {
+            jobs.submit([](void* d, std::size_t, std::size_t) {
+                static_cast<Ctx*>(d)->produced.fetch_add(1);
+            }, &ctx, 0, 1, stage1);
+        }
+        for (int i = 0; i < 8; ++i) {
+            jobs.submit_after(stage1, [](void* d, std::size_t, std::size_t) {
+                auto* c = static_cast<Ctx*>(d);
+                if (c->produced.load() != 64) c->early.fetch_add(1);
+                c->consumed.fetch_add(1);
+            }, &ctx, 0, 1, stage2);
+        }
+        jobs.submit_after(stage2, [](void* d, std::size_t, std::size_t) {
+            auto* c = static_cast<Ctx*>(d);
+            c->final_seen.store(c->consumed.load());
+        }, &ctx, 0, 1, stage3);
+        jobs.wait(stage3);
+        ASSERT_EQ(ctx.early.load(), 0) << round;
+        ASSERT_EQ(ctx.final_seen.load(), 8) << round;
+        // stage1/stage2 are done by now: their last jobs released stage3.
+        EXPECT_TRUE(stage1.done());
+        EXPECT_TRUE(stage2.done());
+    }
+}
+
+TEST(JobSystemTest, SubmitAfterADoneCounterRunsRightAway) {
+    ege::JobSystem jobs(2);
+    ege::JobCounter finished, counter;
+    std::atomic<int> ran{0};
+    jobs.submit_after(finished, [](void* d, std::size_t, std::size_t) {
+        static_cast<std::atomic<int>*>(d)->fetch_add(1);
+    }, &ran, 0, 1, counter);
+    jobs.wait(counter);
+    EXPECT_EQ(ran.load(), 1);
+}
+
+namespace {
+
+struct CountingLayer : ege::Layer {
+    std::atomic<int> updates{0};
+    void on_update(float) override { updates.fetch_add(1, std::memory_order_relaxed); }
+};
+
+struct QuitAfterBackend {
+    int frames_left;
+    std::size_t poll_input(std::span<ege::Event> out) {
+        if (--frames_left > 0 || out.empty()) return 0;
+        out[0] = ege::Event{};
+        out[0].type = ege::EventType::Input;
+        out[0].id = uint32_t(ege::InputCode::Quit);
+        return 1;
+    }
+    void present(const ege::CommandView&) {}
+};
+
+} // namespace
+
+TEST(JobSystemTest, RuntimeFansOutParallelLayerUpdates) {
+    ege::JobSystem jobs(3);
+    QuitAfterBackend backend{5};
+    ege::SPSCRenderPipeline<1024, 4, 8> pipeline;
+    ege::PhysicsSystem physics;
+    ege::RuntimeConfig config;
+    config.pacing.target_fps = 120.0;
+    config.jobs = &jobs;
+    ege::Runtime rt(backend, pipeline, physics, config);
+    CountingLayer a, b, sequential;
+    a.set_parallel_update(true);
+    b.set_parallel_update(true);
+    rt.push_layer(&a);
+    rt.push_layer(&sequential);
+    rt.push_layer(&b);
+    rt.run();
+    EXPECT_GT(sequential.updates.load(), 0);
+    EXPECT_EQ(a.updates.load(), sequential.updates.load());
+    EXPECT_EQ(b.updates.load(), sequential.updates.load());
+}
+
+TEST(JobSystemTest, JobsAloneDoNotChangePhysicsResults) {
+    // Overlapping bodies on the brute-force broadphase, which step_parallel
+    // would silently replace with the spatial hash.
+    auto populate = [](ege::PhysicsSystem& physics) {
+        physics.set_broadphase(ege::physics::Broadphase::BruteForce);
+        for (int i = 0; i < 32; ++i) {
+            ege::physics::Body b;
+            b.pos = {static_cast<float>(i % 8) * 0.7f, static_cast<float>(i / 8) * 0.7f};
+            b.vel = {static_cast<float>(i % 3) - 1.0f, 0.5f};
+            (void)physics.add_body(b);
+        }
+    };
+    ege::JobSystem jobs(3);
+    QuitAfterBackend backend{8};
+    ege::SPSCRenderPipeline<1024, 4, 8> pipeline;
+    ege::PhysicsSystem physics;
+    populate(physics);
+    ege::RuntimeConfig config;
+    config.pacing.target_fps = 120.0;
+    config.jobs = &jobs;
+    ege::Runtime rt(backend, pipeline, physics, config);
+    CountingLayer steps;
+    rt.push_layer(&steps);
+    rt.run();
+
+    ege::PhysicsSystem reference;
+    populate(reference);
+    for (int i = 0; i < steps.updates.load(); ++i) reference.step(1.0f / 60.0f);
+    ASSERT_GT(steps.updates.load(), 0);
+    for (ege::physics::BodyId id = 0; id < 32; ++id) {
+        EXPECT_EQ(physics.body(id).pos.x, reference.body(id).pos.x) << id;
+        EXPECT_EQ(physics.body(id).pos.y, reference.body(id).pos.y) << id;
+    }
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <ege/engine/mpsc_queue.hpp>
+#include <ege/engine/event.hpp>
+
+TEST(MPSCQueueTest, FifoAndCapacity) {
+    ege::MPSCQueue<int, 4> q;
+    int v = 0;
+    EXPECT_FALSE(q.pop(v));
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(q.push(i));
+    EXPECT_FALSE(q.push(4)); // all Capacity slots usable, then full
+    EXPECT_TRUE(q.pop(v));
+    EXPECT_EQ(v, 0);
+    EXPECT_TRUE(q.push(4)); // wraps into the freed slot
+    std::array<int, 8> out{};
+    ASSERT_EQ(q.pop_n(out), 4u);
+    EXPECT_EQ(out[0], 1);
+    EXPECT_EQ(out[3], 4);
+    EXPECT_EQ(q.pop_n(out), 0u);
+}
+
+// Many producers post events concurrently; the consumer must see every event
+// exactly once and each producer's events in the order they were posted.
+TEST(MPSCQueueTest, ManyProducersStress) {
+    constexpr int kProducers = 8;
+    constexpr int kPerProducer = 20000;
+    static ege::MPSCQueue<ege::Event, 256> q;
+
+    std::atomic<bool> go{false};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([p, &go] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (int i = 0; i < kPerProducer; ++i) {
+                ege::Event e{};
+                e.type = ege::EventType::Input;
+                e.id = static_cast<uint32_t>(p);
+                e.payload.i = i;
+                while (!q.push(e)) std::this_thread::yield();
+            }
+        });
+    }
+    go.store(true, std::memory_order_release);
+
+    std::array<int, kProducers> next{};
+    int received = 0;
+    std::array<ege::Event, 32> batch{};
+    while (received < kProducers * kPerProducer) {
+        const std::size_t n = q.pop_n(batch);
+        if (n == 0) { std::this_thread::yield(); continue; }
+        for (std::size_t k = 0; k < n; ++k) {
+            const auto p = static_cast<std::size_t>(batch[k].id);
+            ASSERT_LT(p, next.size());
+            ASSERT_EQ(batch[k].payload.i, next[p]) << "producer " << p;
+            ++next[p];
+        }
+        received += static_cast<int>(n);
+    }
+    for (auto &t : producers) t.join();
+    for (int n : next) EXPECT_EQ(n, kPerProducer);
+    ege::Event e{};
+    EXPECT_FALSE(q.pop(e));
+}
@@ -2,6 +2,9 @@
 
 #include <ege/physics.hpp>
 #include <ege/physics/collision.hpp>
+#include <ege/engine/job_system.hpp>
+
+#include <random>
 
 using namespace ege;
 using namespace ege::physics;
@@ -86,3 +89,218 @@ TEST(PhysicsTest, StaticBodyDoesNotMove)
     float dx = std::fabs(rb.pos.x - ra.pos.x);
     EXPECT_GT(dx, initial_dx);
 }
+
+namespace {
+
+// Deterministic scene mixing circles, boxes and a few static bodies.
+void populate_scene(PhysicsSystem &ps, std::size_t count, float extent, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> pos(-extent, extent);
+    std::uniform_real_distribution<float> vel(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> size(0.2f, 0.6f);
+    for (std::size_t i = 0; i < count; ++i) {
+        Body b;
+        b.pos = {pos(rng), pos(rng)};
+        b.vel = {vel(rng), vel(rng)};
+        b.inv_mass = (i % 16 == 0) ? 0.0f : 1.0f;
+        if (i % 3 == 0) {
+            b.radius = size(rng);
+        } else {
+            b.hx = size(rng);
+            b.hy = size(rng);
+        }
+        ps.add_body(b);
+    }
+}
+
+} // namespace
+
+TEST(PhysicsTest, SpatialHashMatchesBruteForce)
+{
+    PhysicsSystem brute;
+    PhysicsSystem grid;
+    brute.set_broadphase(Broadphase::BruteForce);
+    grid.set_broadphase(Broadphase::SpatialHash);
+    populate_scene(brute, 400, 20.0f, 1234u);
+    populate_scene(grid, 400, 20.0f, 1234u);
+
+    for (int s = 0; s < 10; ++s) {
+        brute.step(1.0f / 60.0f);
+        grid.step(1.0f / 60.0f);
+    }
+
+    for (BodyId id = 0; id < 400; ++id) {
+        EXPECT_EQ(brute.body(id).pos.x, grid.body(id).pos.x) << "body " << id;
+        EXPECT_EQ(brute.body(id).pos.y, grid.body(id).pos.y) << "body " << id;
+    }
+}
+
+TEST(PhysicsTest, SpatialHashFindsPairsAcrossCellBoundaries)
+{
+    PhysicsSystem ps;
+    ps.set_broadphase(Broadphase::SpatialHash);
+    ps.set_cell_size(2.0f);
+    Body a;
+    a.hx = 1.0f;
+    a.hy = 1.0f;
+    a.pos = {-0.5f, -0.5f}; // cell (-1,-1)
+    Body b = a;
+    b.pos = {0.5f, 0.5f};   // cell (0,0)
+
+    auto ida = ps.add_body(a);
+    auto idb = ps.add_body(b);
+    ps.step(1.0f);
+
+    float dx = std::fabs(ps.body(idb).pos.x - ps.body(ida).pos.x);
+    float dy = std::fabs(ps.body(idb).pos.y - ps.body(ida).pos.y);
+    EXPECT_TRUE(dx + EPS >= 2.0f || dy + EPS >= 2.0f);
+}
+
+TEST(PhysicsTest, BruteForceIsTheDefaultBroadphase)
+{
+    PhysicsSystem ps;
+    EXPECT_EQ(ps.broadphase(), Broadphase::BruteForce);
+}
+
+TEST(PhysicsTest, TooSmallCellSizeStillFindsContacts)
+{
+    // Cells far smaller than the bodies would put overlapping bodies several
+    // cells apart; the size is clamped so the pair is still resolved.
+    PhysicsSystem ps;
+    ps.set_broadphase(Broadphase::SpatialHash);
+    ps.set_cell_size(0.1f);
+    Body a;
+    a.hx = 1.0f;
+    a.hy = 1.0f;
+    Body b = a;
+    b.pos = {1.5f, 0.0f};
+    auto ida = ps.add_body(a);
+    auto idb = ps.add_body(b);
+    ps.step(1.0f);
+
+    EXPECT_GE(ps.body(idb).pos.x - ps.body(ida).pos.x + EPS, 2.0f);
+}
+
+TEST(PhysicsTest, IdsSurviveStaticPartitioning)
+{
+    PhysicsSystem ps;
+    std::vector<BodyId> ids;
+    // Interleave static and dynamic bodies far apart so nothing collides.
+    for (int i = 0; i < 11; ++i) {
+        Body b;
+        b.pos = {static_cast<float>(i) * 10.0f, 0.0f};
+        b.vel = {0.0f, 1.0f};
+        b.inv_mass = (i % 3 == 0) ? 0.0f : 1.0f;
+        ids.push_back(ps.add_body(b));
+    }
+    EXPECT_EQ(ps.dynamic_count(), 7u);
+
+    ps.step(1.0f);
+    for (int i = 0; i < 11; ++i) {
+        const Body b = ps.body(ids[static_cast<std::size_t>(i)]);
+        EXPECT_EQ(b.pos.x, static_cast<float>(i) * 10.0f);
+        EXPECT_EQ(b.pos.y, (i % 3 == 0) ? 0.0f : 1.0f) << "body " << i;
+    }
+
+    // Flip one body static and another dynamic; ids keep pointing at them.
+    ps.set_inv_mass(ids[1], 0.0f);
+    ps.set_inv_mass(ids[3], 2.0f);
+    EXPECT_EQ(ps.dynamic_count(), 7u);
+    ps.body(ids[3]).vel = {1.0f, 0.0f};
+    ps.step(1.0f);
+    EXPECT_EQ(ps.body(ids[1]).pos.y, 1.0f);
+    EXPECT_EQ(ps.body(ids[3]).pos.x, 31.0f);
+    EXPECT_EQ(ps.body(ids[3]).inv_mass, 2.0f);
+}
+
+TEST(PhysicsTest, VectorizedIntegrationMatchesScalar)
+{
+    // Odd count exercises both the SIMD body and the scalar tail.
+    float x[13];
+    float v[13];
+    float expected[13];
+    for (int i = 0; i < 13; ++i) {
+        x[i] = static_cast<float>(i) * 0.37f;
+        v[i] = static_cast<float>(i - 6) * 1.9f;
+        expected[i] = x[i] + v[i] * (1.0f / 60.0f);
+    }
+    integrate_linear(x, v, 13, 1.0f / 60.0f);
+    for (int i = 0; i < 13; ++i) EXPECT_EQ(x[i], expected[i]);
+}
+
+TEST(PhysicsTest, VectorizedVec2IntegrationMatchesScalar)
+{
+    // Odd body count: pairs go through the four-lane kernel, the last body doesn't.
+    Vec2 p[7];
+    Vec2 v[7];
+    Vec2 expected[7];
+    for (int i = 0; i < 7; ++i) {
+        p[i] = {static_cast<float>(i) * 0.37f, static_cast<float>(i) * -1.3f};
+        v[i] = {static_cast<float>(i - 3) * 1.9f, static_cast<float>(i) * 0.25f};
+        expected[i] = {p[i].x + v[i].x * (1.0f / 60.0f), p[i].y + v[i].y * (1.0f / 60.0f)};
+    }
+    integrate_linear(p, v, 7, 1.0f / 60.0f);
+    for (int i = 0; i < 7; ++i) {
+        EXPECT_EQ(p[i].x, expected[i].x) << i;
+        EXPECT_EQ(p[i].y, expected[i].y) << i;
+    }
+}
+
+namespace {
+
+struct SerialFor {
+    template<typename Fn>
+    void operator()(std::size_t count, Fn &&fn) const { for (std::size_t i = 0; i < count; ++i) fn(i); }
+};
+
+struct JobsFor {
+    ege::JobSystem *jobs;
+    template<typename Fn>
+    void operator()(std::size_t count, Fn &&fn) const { jobs->parallel_for(count, fn); }
+};
+
+} // namespace
+
+TEST(PhysicsTest, ParallelStepIsDeterministicAcrossThreadCounts)
+{
+    constexpr std::size_t kBodies = 3000;
+    PhysicsSystem serial;
+    populate_scene(serial, kBodies, 40.0f, 99u);
+    for (int s = 0; s < 10; ++s) serial.step_parallel(1.0f / 60.0f, SerialFor{});
+
+    for (std::size_t workers : {1u, 2u, 4u}) {
+        ege::JobSystem jobs(workers);
+        PhysicsSystem parallel;
+        populate_scene(parallel, kBodies, 40.0f, 99u);
+        for (int s = 0; s < 10; ++s) parallel.step_parallel(1.0f / 60.0f, JobsFor{&jobs});
+        for (BodyId id = 0; id < kBodies; ++id) {
+            ASSERT_EQ(serial.body(id).pos.x, parallel.body(id).pos.x) << "workers " << workers << " body " << id;
+            ASSERT_EQ(serial.body(id).pos.y, parallel.body(id).pos.y) << "workers " << workers << " body " << id;
+        }
+    }
+}
+
+TEST(PhysicsTest, ParallelStepResolvesPairsAcrossBlockBoundaries)
+{
+    // Unit cells, 4-cell blocks: x = 3.9 and x = 4.3 sit in neighbouring blocks.
+    PhysicsSystem serial;
+    PhysicsSystem parallel;
+    for (PhysicsSystem *ps : {&serial, &parallel}) {
+        ps->set_cell_size(1.0f);
+        Body a; a.pos = {3.9f, 0.5f}; a.radius = 0.3f;
+        Body b; b.pos = {4.3f, 0.5f}; b.radius = 0.3f;
+        Body c; c.pos = {-4.1f, -0.5f}; c.hx = 0.3f; c.hy = 0.3f;
+        Body d; d.pos = {-3.8f, -0.5f}; d.hx = 0.3f; d.hy = 0.3f;
+        for (const Body &body : {a, b, c, d}) ps->add_body(body);
+    }
+    ege::JobSystem jobs(2);
+    serial.step(1.0f / 60.0f);
+    parallel.step_parallel(1.0f / 60.0f, JobsFor{&jobs});
+    // Each body takes part in a single pair, so order cannot matter.
+    for (BodyId id = 0; id < 4; ++id) {
+        EXPECT_EQ(serial.body(id).pos.x, parallel.body(id).pos.x) << id;
+        EXPECT_EQ(serial.body(id).pos.y, parallel.body(id).pos.y) << id;
+    }
+    EXPECT_GT(parallel.body(1).pos.x - parallel.body(0).pos.x, 0.59f);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <ege/engine/profiler.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const ege::profile::PhaseStats* find_phase(const std::vector<ege::profile::PhaseStats>& stats, const char* name) {
+    const auto it = std::find_if(stats.begin(), stats.end(),
+                                 [name](const ege::profile::PhaseStats& s) { return std::strcmp(s.name, name) == 0; });
+    return it == stats.end() ? nullptr : &*it;
+}
+
+} // namespace
+
+TEST(ProfilerTest, SummaryReportsMinAvgP99PerPhase) {
+    ege::profile::clear();
+    for (uint64_t i = 1; i <= 100; ++i) ege::profile::record("test.phase", 5000, 5000 + i * 1000);
+    ege::profile::record("test.other", 0, 250);
+
+    const auto stats = ege::profile::summary();
+    const auto* phase = find_phase(stats, "test.phase");
+    ASSERT_NE(phase, nullptr);
+    EXPECT_EQ(phase->count, 100u);
+    EXPECT_DOUBLE_EQ(phase->min_us, 1.0);
+    EXPECT_DOUBLE_EQ(phase->avg_us, 50.5);
+    EXPECT_DOUBLE_EQ(phase->p99_us, 100.0);
+    EXPECT_DOUBLE_EQ(phase->max_us, 100.0);
+    const auto* other = find_phase(stats, "test.other");
+    ASSERT_NE(other, nullptr);
+    EXPECT_DOUBLE_EQ(other->avg_us, 0.25);
+
+    ege::profile::clear();
+    EXPECT_EQ(find_phase(ege::profile::summary(), "test.phase"), nullptr);
+}
+
+TEST(ProfilerTest, RingKeepsTheMostRecentSamples) {
+    ege::profile::clear();
+    const std::size_t total = ege::profile::kRingCapacity + 100;
+    for (uint64_t i = 0; i < total; ++i) ege::profile::record("test.ring", 0, i < 100 ? 1'000'000 : 1000);
+    const auto stats = ege::profile::summary();
+    const auto* ring = find_phase(stats, "test.ring");
+    ASSERT_NE(ring, nullptr);
+    EXPECT_EQ(ring->count, ege::profile::kRingCapacity - 1);
+    EXPECT_DOUBLE_EQ(ring->max_us, 1.0); // the 1ms samples were overwritten
+    ege::profile::clear();
+}
+
+TEST(ProfilerTest, ChromeTraceHasEventsFromEveryThread) {
+    ege::profile::clear();
+    std::thread worker([] {
+        ege::profile::set_thread_name("test \"worker\"");
+        const ege::profile::Scope scope("test.worker_scope");
+    });
+    worker.join();
+    {
+        const ege::profile::Scope scope("test.main_scope");
+    }
+
+    const std::string json = ege::profile::chrome_trace_json();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("{\"name\":\"test.main_scope\",\"ph\":\"X\",\"pid\":1,\"tid\":"), std::string::npos);
+    EXPECT_NE(json.find("\"test.worker_scope\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"test \\\"worker\\\"\"}"), std::string::npos);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+    ege::profile::clear();
+}
+
+TEST(ProfilerTest, PreparedThreadRecordsWithoutDropping) {
+    ege::profile::clear();
+    const uint64_t dropped = ege::profile::dropped_samples();
+    std::thread worker([] {
+        EXPECT_TRUE(ege::profile::prepare_thread());
+        EXPECT_TRUE(ege::profile::prepare_thread()); // already allocated
+        const ege::profile::Scope scope("test.prepared_scope");
+    });
+    worker.join();
+    const auto stats = ege::profile::summary();
+    EXPECT_TRUE(std::any_of(stats.begin(), stats.end(), [](const ege::profile::PhaseStats& s) {
+        return std::string_view(s.name) == "test.prepared_scope";
+    }));
+    EXPECT_EQ(ege::profile::dropped_samples(), dropped);
+    ege::profile::clear();
+}
+
+TEST(ProfilerTest, ScopeMacroCompilesOutWhenDisabled) {
+    ege::profile::clear();
+    {
+        EGE_PROFILE_SCOPE("test.macro");
+    }
+    const auto stats = ege::profile::summary();
+    const auto* macro = find_phase(stats, "test.macro");
+#if defined(EGE_PROFILE_ENABLED) && EGE_PROFILE_ENABLED
+    ASSERT_NE(macro, nullptr);
+    EXPECT_EQ(macro->count, 1u);
+#else
+    EXPECT_EQ(macro, nullptr);
+#endif
+    ege::profile::clear();
+}
@@ -0,0 +1,591 @@
+#include <gtest/gtest.h>
+
+#include <ege/engine/command_buffer.hpp>
+#include <ege/raster/palette.hpp>
+#include <ege/raster/tile_rasterizer.hpp>
+#include <ege/raster/span_kernels.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Surfaces {
+    std::size_t w, h;
+    std::vector<uint32_t> ref, tiled;
+    Surfaces(std::size_t width, std::size_t height)
+        : w(width), h(height), ref(width * height, 0xDEADBEEFu), tiled(width * height, 0xDEADBEEFu) {}
+    ege::raster::Target ref_target() { return {ref.data(), w, h, w}; }
+    ege::raster::Target tiled_target() { return {tiled.data(), w, h, w}; }
+};
+
+// Scene shaped like the SDL example: background, a moving rect, a full-screen
+// menu overlay and two buttons.
+template<std::size_t N>
+void record_menu(ege::MemoryCommandBuffer<N> &buf, uint32_t overlay) {
+    buf.push_clear(0xFF001144);
+    buf.push_rect(0, 0xFFFFAA00, 40, 40, 50, 30);
+    buf.push_rect(0, overlay, 0, 0, 320, 240);
+    buf.push_rect(0, 0xFFFFAA00, 50, 82, 220, 30);
+    buf.push_rect(0, 0xFFC0C0C0, 50, 120, 220, 30);
+}
+
+} // namespace
+
+TEST(RasterTest, TiledMatchesReferenceOnMenuScene) {
+    Surfaces s(320, 240);
+    ege::MemoryCommandBuffer<1024> buf;
+    record_menu(buf, 0x80000000);
+
+    ege::raster::rasterize_reference(buf.view(), s.ref_target());
+    ege::raster::TileRasterizer raster(s.w, s.h);
+    raster.render(buf.view(), s.tiled_target());
+    EXPECT_EQ(s.ref, s.tiled);
+
+    // The translucent overlay darkens the background instead of replacing it.
+    EXPECT_EQ(s.tiled[0], ege::raster::blend_pixel(0xFF001144, 0x80000000));
+    EXPECT_NE(s.tiled[0], 0x80000000u);
+}
+
+TEST(RasterTest, OpaqueOverlayOccludesLowerCommands) {
+    Surfaces s(320, 240);
+    ege::MemoryCommandBuffer<1024> buf;
+    record_menu(buf, 0xFF202020);
+
+    ege::raster::RasterStats ref_stats;
+    ege::raster::rasterize_reference(buf.view(), s.ref_target(), &ref_stats);
+    ege::raster::TileRasterizer raster(s.w, s.h);
+    raster.render(buf.view(), s.tiled_target());
+
+    EXPECT_EQ(s.ref, s.tiled);
+    // The overlay hides the clear and the first rect everywhere, so each
+    // pixel is written by the overlay plus at most one button.
+    EXPECT_EQ(raster.stats().pixels_written, 320u * 240u + 2u * 220u * 30u);
+    EXPECT_LT(raster.stats().pixels_written, ref_stats.pixels_written);
+}
+
+TEST(RasterTest, TiledMatchesReferenceOnRandomScenes) {
+    std::mt19937 rng(7u);
+    std::uniform_int_distribution<int> coord(-60, 160);
+    std::uniform_int_distribution<int> size(-10, 90);
+    std::uniform_int_distribution<uint32_t> color;
+    // Odd size so edge tiles are partial.
+    Surfaces s(100, 70);
+    ege::raster::TileRasterizer raster(s.w, s.h);
+    for (int scene = 0; scene < 50; ++scene) {
+        ege::MemoryCommandBuffer<1024> buf;
+        for (int i = 0; i < 40; ++i) {
+            if (i == 20 && scene % 2 == 0) buf.push_clear(color(rng));
+            buf.push_rect(0, color(rng),
+                          static_cast<int16_t>(coord(rng)), static_cast<int16_t>(coord(rng)),
+                          static_cast<int16_t>(size(rng)), static_cast<int16_t>(size(rng)));
+        }
+        ege::raster::rasterize_reference(buf.view(), s.ref_target());
+        raster.render(buf.view(), s.tiled_target());
+        ASSERT_EQ(s.ref, s.tiled) << "scene " << scene;
+    }
+}
+
+TEST(RasterTest, LeadingFullScreenClearSkipsBackgroundFill) {
+    Surfaces s(64, 64);
+    ege::MemoryCommandBuffer<64> buf;
+    buf.push_clear(0xFF123456);
+    ege::raster::TileRasterizer raster(s.w, s.h);
+    raster.render(buf.view(), s.tiled_target());
+    EXPECT_EQ(raster.stats().pixels_written, 64u * 64u);
+    for (uint32_t px : s.tiled) ASSERT_EQ(px, 0xFF123456u);
+
+    // An empty frame still resolves to the zero background.
+    ege::MemoryCommandBuffer<64> empty;
+    raster.render(empty.view(), s.tiled_target());
+    for (uint32_t px : s.tiled) ASSERT_EQ(px, 0u);
+}
+
+TEST(SpanKernelTest, BlendPixelEdgeCases) {
+    using ege::raster::blend_pixel;
+    EXPECT_EQ(blend_pixel(0x12345678u, 0xFFABCDEFu), 0xFFABCDEFu); // opaque replaces
+    EXPECT_EQ(blend_pixel(0x12345678u, 0x00ABCDEFu), 0x12345678u); // transparent keeps
+    EXPECT_EQ(blend_pixel(0xFFFFFFFFu, 0x80000000u), 0xFF7F7F7Fu);
+    EXPECT_EQ(blend_pixel(0x00000000u, 0x80FF0000u), 0x80800000u);
+}
+
+TEST(SpanKernelTest, EveryKernelMatchesReference) {
+    std::mt19937 rng(11u);
+    std::uniform_int_distribution<uint32_t> any;
+    const uint32_t colors[] = {0x00FFFFFFu, 0xFF102030u, 0x80000000u, 0x01FFFFFFu, 0xFE123456u, any(rng), any(rng)};
+    auto kernels = ege::raster::available_span_kernels();
+    ASSERT_FALSE(kernels.empty());
+    for (const auto &k : kernels) {
+        SCOPED_TRACE(k.name);
+        // Lengths around the SIMD widths, with unaligned starts.
+        for (std::size_t offset = 0; offset < 3; ++offset) {
+            for (std::size_t n = 0; n <= 37; ++n) {
+                std::vector<uint32_t> base(n + offset);
+                for (auto &px : base) px = any(rng);
+                for (uint32_t color : colors) {
+                    std::vector<uint32_t> fill = base, blend = base, expect_blend = base;
+                    k.fill(fill.data() + offset, n, color);
+                    k.blend(blend.data() + offset, n, color);
+                    for (std::size_t i = offset; i < base.size(); ++i) {
+                        expect_blend[i] = ege::raster::blend_pixel(base[i], color);
+                    }
+                    for (std::size_t i = 0; i < base.size(); ++i) {
+                        ASSERT_EQ(fill[i], i < offset ? base[i] : color) << "n=" << n << " i=" << i;
+                        ASSERT_EQ(blend[i], expect_blend[i]) << "n=" << n << " i=" << i << " color=" << color;
+                    }
+                }
+            }
+        }
+    }
+}
+
+namespace {
+
+template<std::size_t N>
+void record_cursor_frame(ege::MemoryCommandBuffer<N> &buf, int16_t cx, int16_t cy) {
+    buf.reset();
+    record_menu(buf, 0x80000000);
+    buf.push_rect(0, 0xFFFFFFFF, cx, cy, 4, 4);
+}
+
+} // namespace
+
+TEST(RasterTest, IncrementalMatchesFullRender) {
+    Surfaces s(320, 240);
+    ege::raster::TileRasterizer full(s.w, s.h);
+    ege::raster::TileRasterizer incremental(s.w, s.h);
+    ege::MemoryCommandBuffer<1024> buf;
+    for (int frame = 0; frame < 40; ++frame) {
+        record_cursor_frame(buf, static_cast<int16_t>(frame * 7 % 320), static_cast<int16_t>(frame * 5 % 240));
+        full.render(buf.view(), s.ref_target());
+        incremental.render_incremental(buf.view(), s.tiled_target());
+        ASSERT_EQ(s.ref, s.tiled) << "frame " << frame;
+    }
+}
+
+TEST(RasterTest, IncrementalReportsOnlyChangedTiles) {
+    Surfaces s(320, 240);
+    ege::raster::TileRasterizer raster(s.w, s.h);
+    ege::MemoryCommandBuffer<1024> buf;
+
+    record_cursor_frame(buf, 10, 10);
+    raster.render_incremental(buf.view(), s.tiled_target());
+    EXPECT_EQ(raster.stats().dirty_tiles, raster.stats().tiles); // first frame: everything
+    ASSERT_EQ(raster.dirty_rects().size(), 1u);
+    EXPECT_EQ(raster.dirty_rects()[0].w, 320);
+    EXPECT_EQ(raster.dirty_rects()[0].h, 240);
+
+    // Same commands again: nothing to redraw or upload.
+    record_cursor_frame(buf, 10, 10);
+    raster.render_incremental(buf.view(), s.tiled_target());
+    EXPECT_EQ(raster.stats().dirty_tiles, 0u);
+    EXPECT_TRUE(raster.dirty_rects().empty());
+
+    // Cursor moves from tile (0,0) to tile (5,3): only those two tiles change.
+    record_cursor_frame(buf, 170, 100);
+    raster.render_incremental(buf.view(), s.tiled_target());
+    EXPECT_EQ(raster.stats().dirty_tiles, 2u);
+    ASSERT_EQ(raster.dirty_rects().size(), 2u);
+    for (const auto &r : raster.dirty_rects()) {
+        EXPECT_EQ(r.w, 32);
+        EXPECT_EQ(r.h, 32);
+    }
+
+    // After invalidate() the next frame is a full redraw again.
+    raster.invalidate();
+    raster.render_incremental(buf.view(), s.tiled_target());
+    EXPECT_EQ(raster.stats().dirty_tiles, raster.stats().tiles);
+}
+
+namespace {
+
+// 64x32 sheet: two 32x32 frames with distinct per-pixel colours, a magenta
+// colour-key border and keyed holes.
+struct TestAtlas {
+    static constexpr uint32_t kKey = 0xFFFF00FF;
+    std::vector<uint32_t> pixels;
+    ege::SpriteAtlas atlas;
+    TestAtlas() : pixels(64 * 32) {
+        for (uint32_t y = 0; y < 32; ++y) {
+            for (uint32_t x = 0; x < 64; ++x) {
+                const bool hole = (x % 32 == 0) || (y == 0) || ((x * 7 + y * 3) % 11 == 0);
+                pixels[y * 64 + x] = hole ? kKey : (0xFF000000u | (x << 16) | (y << 8) | (x ^ y));
+            }
+        }
+        atlas.pixels = pixels.data();
+        atlas.width = 64;
+        atlas.height = 32;
+        atlas.pitch = 64;
+        atlas.color_key = kKey;
+        atlas.use_color_key = true;
+    }
+};
+
+} // namespace
+
+TEST(RasterTest, SpritesMatchReferenceWithKeyFlipAndClipping) {
+    TestAtlas sheet;
+    for (bool keyed : {true, false}) {
+        sheet.atlas.use_color_key = keyed;
+        Surfaces s(100, 70);
+        ege::raster::SpriteAtlases atlases;
+        atlases.set(1, &sheet.atlas);
+        ege::raster::TileRasterizer raster(s.w, s.h);
+        raster.set_atlas(1, &sheet.atlas);
+
+        ege::MemoryCommandBuffer<1024> buf;
+        buf.push_clear(0xFF102030);
+        const ege::SpriteFrame frames[] = {{1, 1, 31, 31}, {32, 0, 32, 32}, {5, 3, 17, 9}};
+        int16_t x = -13;
+        for (uint8_t flags = 0; flags < 4; ++flags) {
+            for (const auto &f : frames) {
+                buf.push_sprite(0, 1, f, x, static_cast<int16_t>(x / 2 - 5), flags);
+                x = static_cast<int16_t>(x + 23);
+            }
+        }
+        buf.push_sprite(0, 2, frames[0], 10, 10); // unregistered atlas: skipped
+        buf.push_sprite(0, 1, ege::SpriteFrame{40, 0, 32, 32}, 10, 10); // outside the atlas: skipped
+        buf.push_rect(0, 0x80FFFFFF, 20, 20, 40, 20);
+
+        ege::raster::rasterize_reference(buf.view(), s.ref_target(), nullptr, &atlases);
+        raster.render(buf.view(), s.tiled_target());
+        EXPECT_EQ(s.ref, s.tiled) << "keyed " << keyed;
+    }
+}
+
+TEST(RasterTest, SpriteReplacesPerPixelRects) {
+    // What layers used to do: one 1x1 rect per opaque sprite pixel.
+    TestAtlas sheet;
+    const ege::SpriteFrame f{32, 0, 32, 32};
+    Surfaces s(64, 64);
+    ege::raster::TileRasterizer raster(s.w, s.h);
+    raster.set_atlas(0, &sheet.atlas);
+
+    ege::MemoryCommandBuffer<1024> sprite;
+    sprite.push_clear(0xFF000000);
+    sprite.push_sprite(0, 0, f, 9, 17, ege::SpriteFlipX);
+    raster.render(sprite.view(), s.tiled_target());
+
+    ege::MemoryCommandBuffer<16384> rects;
+    rects.push_clear(0xFF000000);
+    for (int16_t y = 0; y < f.h; ++y) {
+        for (int16_t x = 0; x < f.w; ++x) {
+            const uint32_t v = sheet.pixels[static_cast<std::size_t>(f.y + y) * 64 + static_cast<std::size_t>(f.x + f.w - 1 - x)];
+            if (v != TestAtlas::kKey) rects.push_rect(0, v, static_cast<int16_t>(9 + x), static_cast<int16_t>(17 + y), 1, 1);
+        }
+    }
+    ege::raster::rasterize_reference(rects.view(), s.ref_target());
+    EXPECT_EQ(s.ref, s.tiled);
+    EXPECT_LT(sprite.size() * 100, rects.size());
+}
+
+TEST(RasterTest, IncrementalRedrawsSpritesWhenAtlasVersionChanges) {
+    TestAtlas sheet;
+    sheet.atlas.use_color_key = false;
+    Surfaces s(128, 96);
+    ege::raster::SpriteAtlases atlases;
+    atlases.set(0, &sheet.atlas);
+    ege::raster::TileRasterizer raster(s.w, s.h);
+    raster.set_atlas(0, &sheet.atlas);
+
+    ege::MemoryCommandBuffer<1024> buf;
+    buf.push_clear(0xFF000000);
+    buf.push_rect(0, 0xFF00FF00, 80, 60, 20, 20);
+    buf.push_sprite(0, 0, ege::SpriteFrame{32, 0, 32, 32}, 10, 10);
+    raster.render_incremental(buf.view(), s.tiled_target());
+
+    // Animate the sheet in place; the command stream is unchanged.
+    for (auto& px : sheet.pixels) px ^= 0x00FFFFFFu;
+    ++sheet.atlas.version;
+    raster.render_incremental(buf.view(), s.tiled_target());
+    ege::raster::rasterize_reference(buf.view(), s.ref_target(), nullptr, &atlases);
+    EXPECT_EQ(s.ref, s.tiled);
+    // Only the tiles under the sprite are redrawn.
+    EXPECT_GT(raster.stats().dirty_tiles, 0u);
+    EXPECT_LT(raster.stats().dirty_tiles, raster.stats().tiles);
+}
+
+TEST(SpanKernelTest, SpriteCopiesMatchScalar) {
+    std::vector<uint32_t> src(67);
+    for (std::size_t i = 0; i < src.size(); ++i) src[i] = (i % 5 == 0) ? 0xFFFF00FFu : static_cast<uint32_t>(i * 2654435761u);
+    for (std::size_t n : {0u, 1u, 3u, 4u, 7u, 16u, 33u, 67u}) {
+        std::vector<uint32_t> a(n, 0x12345678u), b(n, 0x12345678u);
+        ege::raster::copy_span_keyed(a.data(), src.data(), n, 0xFFFF00FFu);
+        for (std::size_t i = 0; i < n; ++i) if (src[i] != 0xFFFF00FFu) b[i] = src[i];
+        EXPECT_EQ(a, b) << n;
+
+        if (n == 0) continue;
+        std::vector<uint32_t> c(n, 0x12345678u), d(n, 0x12345678u), e(n), f(n);
+        ege::raster::copy_span_keyed_reversed(c.data(), src.data() + n - 1, n, 0xFFFF00FFu);
+        ege::raster::copy_span_reversed(e.data(), src.data() + n - 1, n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const uint32_t v = src[n - 1 - i];
+            if (v != 0xFFFF00FFu) d[i] = v;
+            f[i] = v;
+        }
+        EXPECT_EQ(c, d) << n;
+        EXPECT_EQ(e, f) << n;
+    }
+}
+
+TEST(RasterTest, IndexedMatchesReferenceAndUsesOneBytePerPixel) {
+    std::mt19937 rng(11u);
+    std::uniform_int_distribution<int> coord(-60, 160);
+    std::uniform_int_distribution<int> size(-10, 90);
+    std::uniform_int_distribution<uint32_t> color;
+    constexpr std::size_t w = 100, h = 70;
+    std::vector<uint8_t> ref(w * h, 0xAA), tiled(w * h, 0xAA);
+    ege::raster::TileRasterizer raster(w, h);
+    for (int scene = 0; scene < 30; ++scene) {
+        ege::MemoryCommandBuffer<1024> buf;
+        for (int i = 0; i < 40; ++i) {
+            if (i == 20 && scene % 2 == 0) buf.push_clear(color(rng));
+            // Alpha bits are ignored in indexed mode: every index is opaque.
+            buf.push_rect(0, color(rng),
+                          static_cast<int16_t>(coord(rng)), static_cast<int16_t>(coord(rng)),
+                          static_cast<int16_t>(size(rng)), static_cast<int16_t>(size(rng)));
+        }
+        ege::raster::rasterize_reference(buf.view(), ege::raster::IndexedTarget{ref.data(), w, h, w});
+        if (scene % 3 == 2) raster.render_incremental(buf.view(), ege::raster::IndexedTarget{tiled.data(), w, h, w});
+        else raster.render(buf.view(), ege::raster::IndexedTarget{tiled.data(), w, h, w});
+        ASSERT_EQ(ref, tiled) << "scene " << scene;
+    }
+    // Footprint: a quarter of the ARGB8888 framebuffer.
+    EXPECT_EQ(tiled.size() * sizeof(tiled[0]) * 4, w * h * sizeof(uint32_t));
+}
+
+TEST(RasterTest, IndexedSpritesDrawFromIndexSheet) {
+    // Index sheet mirroring TestAtlas: index 7 is the key.
+    TestAtlas sheet;
+    std::vector<uint8_t> indices(sheet.pixels.size());
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        indices[i] = sheet.pixels[i] == TestAtlas::kKey ? 7 : static_cast<uint8_t>(8 + i % 200);
+    }
+    constexpr std::size_t w = 100, h = 70;
+    for (bool keyed : {true, false}) {
+        ege::SpriteAtlas indexed = sheet.atlas;
+        indexed.indices = indices.data();
+        indexed.color_key = 7;
+        indexed.use_color_key = keyed;
+        ege::raster::SpriteAtlases atlases;
+        atlases.set(1, &indexed);
+        atlases.set(2, &sheet.atlas); // ARGB only: skipped in indexed mode
+        ege::raster::TileRasterizer raster(w, h);
+        raster.set_atlas(1, &indexed);
+        raster.set_atlas(2, &sheet.atlas);
+
+        ege::MemoryCommandBuffer<1024> buf;
+        buf.push_clear(3);
+        int16_t x = -13;
+        for (uint8_t flags = 0; flags < 4; ++flags) {
+            buf.push_sprite(0, 1, ege::SpriteFrame{1, 1, 31, 31}, x, static_cast<int16_t>(x / 2 - 5), flags);
+            buf.push_sprite(0, 1, ege::SpriteFrame{32, 0, 32, 32}, static_cast<int16_t>(x + 11), 30, flags);
+            x = static_cast<int16_t>(x + 29);
+        }
+        buf.push_sprite(0, 2, ege::SpriteFrame{1, 1, 31, 31}, 10, 10);
+        buf.push_rect(0, 5, 20, 20, 40, 20);
+
+        std::vector<uint8_t> ref(w * h, 0xAA), tiled(w * h, 0xAA);
+        ege::raster::RasterStats ref_stats;
+        ege::raster::rasterize_reference(buf.view(), ege::raster::IndexedTarget{ref.data(), w, h, w}, &ref_stats, &atlases);
+        raster.render(buf.view(), ege::raster::IndexedTarget{tiled.data(), w, h, w});
+        EXPECT_EQ(ref, tiled) << "keyed " << keyed;
+        EXPECT_EQ(ref_stats.skipped_sprites, 1u);
+        EXPECT_EQ(raster.stats().skipped_sprites, 1u);
+        // Unflipped frame {32, 0} drawn at (-2, 30): screen (1, 31) shows atlas (35, 1).
+        EXPECT_EQ(tiled[31 * w + 1], indices[1 * 64 + 35]);
+    }
+}
+
+TEST(RasterTest, IndexedIncrementalMatchesFullRender) {
+    constexpr std::size_t w = 320, h = 240;
+    std::vector<uint8_t> full_px(w * h), inc_px(w * h);
+    ege::raster::TileRasterizer full(w, h);
+    ege::raster::TileRasterizer incremental(w, h);
+    ege::MemoryCommandBuffer<1024> buf;
+    std::vector<uint32_t> argb(w * h);
+    for (int frame = 0; frame < 20; ++frame) {
+        record_cursor_frame(buf, static_cast<int16_t>(frame * 7 % 320), static_cast<int16_t>(frame * 5 % 240));
+        full.render(buf.view(), ege::raster::IndexedTarget{full_px.data(), w, h, w});
+        incremental.render_incremental(buf.view(), ege::raster::IndexedTarget{inc_px.data(), w, h, w});
+        ASSERT_EQ(full_px, inc_px) << "frame " << frame;
+        if (frame == 10) {
+            // Switching modes must not diff against the indexed history.
+            incremental.render_incremental(buf.view(), ege::raster::Target{argb.data(), w, h, w});
+            EXPECT_EQ(incremental.stats().dirty_tiles, incremental.stats().tiles);
+        }
+    }
+}
+
+TEST(PaletteTest, ExpandsThroughLutAndSwapsWithoutRerendering) {
+    constexpr std::size_t w = 8, h = 4;
+    std::vector<uint8_t> px(w * h);
+    ege::MemoryCommandBuffer<256> buf;
+    buf.push_clear(1);
+    buf.push_rect(0, 2, 2, 1, 3, 2);
+    ege::raster::TileRasterizer raster(w, h);
+    const ege::raster::IndexedTarget target{px.data(), w, h, w};
+    raster.render(buf.view(), target);
+
+    ege::raster::Palette pal;
+    pal.set(1, 0xFF000080);
+    pal.set(2, 0xFFFF0000);
+    std::vector<uint32_t> out(w * h);
+    const ege::raster::DirtyRect all{0, 0, static_cast<int32_t>(w), static_cast<int32_t>(h)};
+    ege::raster::expand_indexed(target, pal, all, out.data(), w);
+    EXPECT_EQ(out[0], 0xFF000080u);
+    EXPECT_EQ(out[1 * w + 2], 0xFFFF0000u);
+
+    // Swap: same indices, new colours.
+    const uint32_t v = pal.version();
+    pal.set(2, 0xFF00FF00);
+    EXPECT_NE(pal.version(), v);
+    ege::raster::expand_indexed(target, pal, all, out.data(), w);
+    EXPECT_EQ(out[1 * w + 2], 0xFF00FF00u);
+
+    // Sub-rectangle expansion writes relative to `dst`.
+    std::vector<uint32_t> sub(3 * 2, 0u);
+    ege::raster::expand_indexed(target, pal, {2, 1, 3, 2}, sub.data(), 3);
+    for (uint32_t c : sub) EXPECT_EQ(c, 0xFF00FF00u);
+
+    std::vector<uint16_t> out565(w * h);
+    ege::raster::expand_indexed_rgb565(target, pal, all, out565.data(), w);
+    EXPECT_EQ(out565[1 * w + 2], 0x07E0u);
+    EXPECT_EQ(out565[0], 0x0010u);
+}
+
+TEST(PaletteTest, RotateCyclesRange) {
+    ege::raster::Palette pal;
+    const uint32_t colors[] = {10, 11, 12, 13};
+    pal.load(colors, 4);
+    pal.rotate(4, 4, 1);
+    EXPECT_EQ(pal[4], 13u);
+    EXPECT_EQ(pal[5], 10u);
+    EXPECT_EQ(pal[7], 12u);
+    pal.rotate(4, 4, -1);
+    EXPECT_EQ(pal[4], 10u);
+    EXPECT_EQ(pal[3], 0u);
+    EXPECT_EQ(pal[8], 0u);
+    // Loads past the last entry are truncated.
+    pal.load(colors, 254);
+    EXPECT_EQ(pal[255], 11u);
+}
+
+TEST(RasterTest, RectBatchMatchesIndividualRects) {
+    std::mt19937 rng(13u);
+    std::uniform_int_distribution<int> coord(-20, 110);
+    std::uniform_int_distribution<int> size(-2, 12);
+    std::vector<ege::RectInstance> particles(500);
+    for (auto &r : particles) {
+        r = {static_cast<int16_t>(coord(rng)), static_cast<int16_t>(coord(rng)),
+             static_cast<int16_t>(size(rng)), static_cast<int16_t>(size(rng))};
+    }
+    for (uint32_t color : {0xFFFFFFFFu, 0x60FF8000u}) {
+        ege::MemoryCommandBuffer<8192> batched, single;
+        for (auto *b : {&batched, &single}) b->push_clear(0xFF102030);
+        batched.push_rect_batch(1, color, particles);
+        for (const auto &r : particles) single.push_rect(1, color, r.x, r.y, r.w, r.h);
+
+        Surfaces s(100, 70);
+        ege::raster::rasterize_reference(single.view(), s.ref_target());
+        ege::raster::TileRasterizer raster(s.w, s.h);
+        raster.render(batched.view(), s.tiled_target());
+        EXPECT_EQ(s.ref, s.tiled);
+        const uint32_t commands = raster.stats().commands;
+
+        std::vector<uint32_t> ref_batched(s.w * s.h);
+        ege::raster::rasterize_reference(batched.view(), {ref_batched.data(), s.w, s.h, s.w});
+        EXPECT_EQ(s.ref, ref_batched);
+
+        raster.render(single.view(), s.tiled_target());
+        EXPECT_EQ(s.ref, s.tiled);
+        EXPECT_EQ(raster.stats().commands, commands);
+    }
+}
+
+TEST(RasterTest, LayersPaintInOrderRegardlessOfRecordOrder) {
+    Surfaces s(64, 64);
+    ege::MemoryCommandBuffer<1024> buf;
+    buf.push_rect(2, 0xFF0000FF, 0, 0, 32, 32);  // top layer, recorded first
+    buf.push_rect(1, 0x80FF0000, 16, 16, 32, 32); // translucent middle layer
+    buf.push_rect(0, 0xFF00FF00, 0, 0, 64, 64);  // background, recorded last
+    buf.push_rect(2, 0xFFFFFFFF, 40, 40, 8, 8);  // same layer keeps record order...
+    buf.push_rect(2, 0xFF000000, 44, 44, 8, 8);  // ...so this one ends on top
+
+    ege::raster::TileRasterizer raster(s.w, s.h);
+    raster.render(buf.view(), s.tiled_target());
+    ege::raster::rasterize_reference(buf.view(), s.ref_target());
+    EXPECT_EQ(s.ref, s.tiled);
+    EXPECT_EQ(s.tiled[5 * 64 + 5], 0xFF0000FFu);
+    EXPECT_EQ(s.tiled[20 * 64 + 40], ege::raster::blend_pixel(0xFF00FF00, 0x80FF0000));
+    EXPECT_EQ(s.tiled[45 * 64 + 45], 0xFF000000u);
+    EXPECT_EQ(s.tiled[41 * 64 + 41], 0xFFFFFFFFu);
+
+    // FrameBuffer decoding still reports record order.
+    ege::FrameBuffer<8> decoded;
+    buf.decode(decoded);
+    EXPECT_EQ(decoded.commands[0].layer, 2u);
+}
+
+TEST(RasterTest, ClearWipesHigherLayersRecordedBeforeIt) {
+    Surfaces s(64, 64);
+    ege::MemoryCommandBuffer<1024> buf;
+    buf.push_rect(3, 0xFF0000FF, 0, 0, 32, 32);  // wiped by the clear below
+    buf.push_clear(0xFF101010);
+    buf.push_rect(2, 0xFFFFFFFF, 32, 32, 16, 16); // after the clear: sorted...
+    buf.push_rect(1, 0xFF00FF00, 24, 24, 32, 32); // ...among themselves only
+
+    ege::raster::TileRasterizer raster(s.w, s.h);
+    raster.render(buf.view(), s.tiled_target());
+    ege::raster::rasterize_reference(buf.view(), s.ref_target());
+    EXPECT_EQ(s.ref, s.tiled);
+    EXPECT_EQ(s.tiled[5 * 64 + 5], 0xFF101010u);
+    EXPECT_EQ(s.tiled[26 * 64 + 26], 0xFF00FF00u);
+    EXPECT_EQ(s.tiled[40 * 64 + 40], 0xFFFFFFFFu);
+    EXPECT_EQ(raster.stats().commands, 4u);
+    EXPECT_EQ(raster.stats().occluded_commands, 1u);
+}
+
+TEST(RasterTest, CommandsUnderHigherOpaqueLayerAreDropped) {
+    Surfaces s(128, 96);
+    ege::MemoryCommandBuffer<1024> buf;
+    // A full-screen HUD panel on layer 5 is recorded first; the world
+    // (layer 0) is recorded afterwards but lies completely under it except
+    // for one rect that peeks out.
+    buf.push_rect(5, 0xFF202020, 0, 0, 128, 80);
+    for (int i = 0; i < 20; ++i) buf.push_rect(0, 0xFF00FF00u + static_cast<uint32_t>(i), static_cast<int16_t>(i * 3), 10, 20, 20);
+    buf.push_rect(0, 0xFFFF0000, 10, 70, 30, 20);
+    buf.push_rect(0, 0x80FFFFFF, 50, 20, 10, 10); // translucent, still hidden
+
+    ege::raster::TileRasterizer raster(s.w, s.h);
+    raster.render(buf.view(), s.tiled_target());
+    ege::raster::rasterize_reference(buf.view(), s.ref_target());
+    EXPECT_EQ(s.ref, s.tiled);
+    EXPECT_EQ(raster.stats().commands, 23u);
+    EXPECT_EQ(raster.stats().occluded_commands, 21u);
+    EXPECT_EQ(s.tiled[85 * 128 + 20], 0xFFFF0000u);
+}
+
+TEST(RasterTest, LayeredRandomScenesMatchReference) {
+    std::mt19937 rng(17u);
+    std::uniform_int_distribution<int> coord(-40, 120);
+    std::uniform_int_distribution<int> size(0, 100);
+    std::uniform_int_distribution<uint32_t> color, layer(0, 4);
+    Surfaces s(100, 70);
+    ege::raster::TileRasterizer raster(s.w, s.h);
+    for (int scene = 0; scene < 40; ++scene) {
+        ege::MemoryCommandBuffer<2048> buf;
+        for (int i = 0; i < 60; ++i) {
+            uint32_t c = color(rng);
+            if (i % 2 == 0) c |= 0xFF000000u; // plenty of opaque occluders
+            if (i == 20 + scene % 20) buf.push_clear(c); // barrier mid-frame
+            buf.push_rect(static_cast<uint8_t>(layer(rng)), c,
+                          static_cast<int16_t>(coord(rng)), static_cast<int16_t>(coord(rng)),
+                          static_cast<int16_t>(size(rng)), static_cast<int16_t>(size(rng)));
+        }
+        ege::raster::rasterize_reference(buf.view(), s.ref_target());
+        if (scene % 2) raster.render_incremental(buf.view(), s.tiled_target());
+        else raster.render(buf.view(), s.tiled_target());
+        ASSERT_EQ(s.ref, s.tiled) << "scene " << scene;
+    }
+}
@@ -3,6 +3,9 @@
 #include <ege/engine/render_pipeline.hpp>
 #include <ege/engine/render_command.hpp>
 
+#include <atomic>
+#include <thread>
+
 TEST(RenderPipelineTest, ProduceConsume) {
     using Pipeline = ege::SPSCRenderPipeline<256, 4>;
     Pipeline pipeline;
@@ -29,3 +32,93 @@ TEST(RenderPipelineTest, ProduceConsume) {
     // release buffer back to pool
     EXPECT_TRUE(pipeline.release_buffer(idx));
 }
+
+TEST(MailboxPipelineTest, ConsumerGetsNewestFrame) {
+    ege::MailboxRenderPipeline<256> pipeline;
+
+    uint32_t idx;
+    (void)pipeline.try_consume(idx);
+    EXPECT_EQ(idx, UINT32_MAX); // nothing submitted yet
+
+    // Producer never blocks: submit three frames without consuming any.
+    for (uint32_t frame = 1; frame <= 3; ++frame) {
+        auto opt = pipeline.begin_frame();
+        ASSERT_TRUE(opt.has_value());
+        opt->get().push_clear(frame);
+        pipeline.submit_frame();
+    }
+    EXPECT_EQ(pipeline.overwritten_frames(), 2u);
+
+    const auto &buf = pipeline.try_consume(idx);
+    ASSERT_NE(idx, UINT32_MAX);
+    ege::FrameBuffer<4> out;
+    ASSERT_EQ(buf.decode(out), 1u);
+    EXPECT_EQ(out.commands[0].color, 3u);
+    EXPECT_TRUE(pipeline.release_buffer(idx));
+
+    // No stale frame is handed out twice.
+    (void)pipeline.try_consume(idx);
+    EXPECT_EQ(idx, UINT32_MAX);
+}
+
+TEST(MailboxPipelineTest, ConcurrentFramesAreNeverTornOrStale) {
+    ege::MailboxRenderPipeline<1024> pipeline;
+    constexpr uint32_t frames = 20000;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        for (uint32_t frame = 1; frame <= frames; ++frame) {
+            auto &buf = pipeline.begin_frame()->get();
+            // Every command in a frame carries the frame number.
+            for (int i = 0; i < 16; ++i) buf.push_rect(0, frame, 0, 0, 1, 1);
+            pipeline.submit_frame();
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint32_t last = 0;
+    bool ok = true;
+    auto consume = [&] {
+        uint32_t idx;
+        const auto &buf = pipeline.try_consume(idx);
+        if (idx == UINT32_MAX) return;
+        uint32_t seen = 0;
+        std::size_t count = buf.for_each([&](const ege::RenderCommand &cmd) {
+            if (seen == 0) seen = cmd.color;
+            if (cmd.color != seen) ok = false;
+        });
+        if (count != 16 || seen <= last) ok = false;
+        last = seen;
+        (void)pipeline.release_buffer(idx);
+    };
+    while (!done.load(std::memory_order_acquire)) consume();
+    producer.join();
+    consume();
+
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(last, frames);
+}
+
+TEST(MailboxPipelineTest, ReleasingAReplacedFrontBufferIsRejected) {
+    ege::MailboxRenderPipeline<256> pipeline;
+    auto submit = [&](uint32_t color) {
+        auto opt = pipeline.begin_frame();
+        ASSERT_TRUE(opt.has_value());
+        opt->get().push_clear(color);
+        pipeline.submit_frame();
+    };
+    // A frame is published between two consumes, as a producer thread can.
+    submit(1);
+    uint32_t first;
+    (void)pipeline.try_consume(first);
+    submit(2);
+    uint32_t second;
+    const auto &buf = pipeline.try_consume(second);
+    ASSERT_NE(second, UINT32_MAX);
+    EXPECT_NE(first, second);
+    EXPECT_FALSE(pipeline.release_buffer(first));
+    uint32_t color = 0;
+    buf.for_each([&color](const ege::RenderCommand &cmd) { color = cmd.color; });
+    EXPECT_EQ(color, 2u);
+    EXPECT_TRUE(pipeline.release_buffer(second));
+}
@@ -0,0 +1,356 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <span>
+#include <thread>
+#include <ege/runtime.hpp>
+
+// Count every global heap allocation made by the test binary.
+namespace {
+std::atomic<std::size_t> g_allocations{0};
+}
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+// Backend that feeds a few input events every frame and records how many
+// heap allocations had happened when each frame started.
+struct FakeBackend {
+    static constexpr int kFrames = 32;
+    ege::SPSCQueue<ege::Event, 1024> queue;
+    std::array<std::size_t, kFrames> allocs_at_frame{};
+    int frame = 0;
+    std::size_t events_delivered = 0;
+    std::size_t presented = 0;
+
+    bool init(std::size_t, std::size_t) { return true; }
+    void shutdown() {}
+    void present(const ege::CommandView& view) { presented += view.for_each([](const ege::RenderCommand&) {}); }
+    std::size_t poll_input(std::span<ege::Event> out) {
+        allocs_at_frame[static_cast<std::size_t>(frame)] = g_allocations.load(std::memory_order_relaxed);
+        for (int i = 0; i < 3; ++i) {
+            ege::Event e{};
+            e.type = ege::EventType::Input;
+            e.id = 3; // right mouse button (id 1 doubles as InputCode::Quit)
+            e.payload.i = 1;
+            e.pos = {i, frame};
+            (void)queue.push(e);
+        }
+        if (++frame == kFrames) {
+            ege::Event quit{};
+            quit.type = ege::EventType::Input;
+            quit.id = uint32_t(ege::InputCode::Quit);
+            (void)queue.push(quit);
+        }
+        const std::size_t n = queue.pop_n(out);
+        events_delivered += n;
+        return n;
+    }
+    bool open_audio(int) { return true; }
+    void trigger_sound(uint32_t, float, uint32_t) {}
+    bool try_pop_event(ege::Event& out) { return queue.pop(out); }
+    std::size_t drain_events(std::span<ege::Event> out) { return queue.pop_n(out); }
+};
+
+static_assert(ege::backend::BackendConcept<FakeBackend>);
+
+struct DrawLayer : ege::Layer {
+    int clicks = 0;
+    int updates = 0;
+    bool on_event(const ege::Event& e) override { clicks += e.is_right_click() ? 1 : 0; return false; }
+    void on_update(float) override { ++updates; }
+    void on_render(int frame_count) override {
+        cmdbuf_->push_clear(0xFF000000);
+        cmdbuf_->push_rect(0, 0xFFFFFFFF, static_cast<int16_t>(frame_count % 100), 10, 20, 20);
+    }
+};
+
+// Every command of frame n carries colour n.
+struct StampLayer : ege::Layer {
+    void on_render(int frame_count) override {
+        const auto stamp = static_cast<uint32_t>(frame_count);
+        cmdbuf_->push_clear(stamp);
+        for (int16_t i = 0; i < 16; ++i) cmdbuf_->push_rect(0, stamp, i, i, 4, 4);
+    }
+};
+
+// Backend for threaded runs: quits on poll number `frames`, optionally
+// sleeping in every poll so the render thread parks between frames.
+struct ThreadedBackend {
+    int frames = 0;
+    std::chrono::microseconds poll_delay{0};
+    int polls = 0; // simulation thread only
+    std::thread::id sim_thread = std::this_thread::get_id();
+    std::atomic<int> presented{0};
+    std::atomic<int> presented_on_sim_thread{0};
+    std::atomic<int64_t> last_stamp{-1};
+    std::size_t poll_input(std::span<ege::Event> out) {
+        std::this_thread::sleep_for(poll_delay);
+        if (polls++ < frames || out.empty()) return 0;
+        out[0] = ege::Event{};
+        out[0].type = ege::EventType::Input;
+        out[0].id = uint32_t(ege::InputCode::Quit);
+        return 1;
+    }
+    void present(const ege::CommandView& view) {
+        if (std::this_thread::get_id() == sim_thread) presented_on_sim_thread.fetch_add(1);
+        view.for_each([this](const ege::RenderCommand& cmd) {
+            if (cmd.type == ege::RenderCommandType::Clear) last_stamp.store(cmd.color);
+        });
+        presented.fetch_add(1);
+    }
+};
+
+// True when all `count` buffers of `pipeline` are back in its free pool.
+// Every buffer taken for the check is handed back afterwards.
+template<typename Pipeline>
+bool all_buffers_free(Pipeline& pipeline, std::size_t count) {
+    std::size_t acquired = 0;
+    while (acquired < count && pipeline.begin_frame()) {
+        pipeline.submit_frame();
+        ++acquired;
+    }
+    while (true) {
+        uint32_t idx;
+        (void)pipeline.try_consume(idx);
+        if (idx == UINT32_MAX) break;
+        (void)pipeline.release_buffer(idx);
+    }
+    return acquired == count;
+}
+
+} // namespace
+
+TEST(RuntimeTest, SteadyStateFrameDoesNotAllocate) {
+    FakeBackend backend;
+    ege::SPSCRenderPipeline<1024, 4, 8> pipeline;
+    ege::PhysicsSystem physics;
+    physics.reserve(8);
+    for (int i = 0; i < 8; ++i) {
+        ege::physics::Body b;
+        b.pos = {static_cast<float>(i) * 0.5f, 0.0f};
+        b.vel = {1e8f, 0.0f}; // 0.1 units per 1 ns step
+        (void)physics.add_body(b);
+    }
+    ege::RuntimeConfig config;
+    config.pacing.target_fps = 0.0; // run frames back to back
+    // A 1 ns step is always due, so every frame runs exactly one update and
+    // one physics step inside the measured window.
+    config.pacing.update_hz = 1e9;
+    config.pacing.max_updates_per_frame = 1;
+    ege::Runtime rt(backend, pipeline, physics, config);
+    DrawLayer layer;
+    layer.show();
+    rt.push_layer(&layer);
+    rt.run();
+
+    ASSERT_EQ(backend.frame, FakeBackend::kFrames);
+    EXPECT_EQ(layer.clicks, 3 * FakeBackend::kFrames);
+    EXPECT_EQ(layer.updates, FakeBackend::kFrames);
+    EXPECT_GT(physics.body(7).pos.x, 3.5f + 3.0f); // 32 steps of 0.1
+    EXPECT_GT(backend.presented, 0u);
+    // The first frames may size buffers lazily; after that, a frame must not
+    // touch the heap.
+    EXPECT_EQ(backend.allocs_at_frame[4], backend.allocs_at_frame[FakeBackend::kFrames - 1]);
+}
+
+TEST(RuntimeTest, EventsBeyondFrameCapacityAreDeliveredLater) {
+    ege::SPSCQueue<ege::Event, 16> queue;
+    for (int i = 0; i < 10; ++i) {
+        ege::Event e{};
+        e.id = static_cast<uint32_t>(i);
+        ASSERT_TRUE(queue.push(e));
+    }
+    std::array<ege::Event, 4> out{};
+    ASSERT_EQ(queue.pop_n(out), 4u);
+    EXPECT_EQ(out[0].id, 0u);
+    EXPECT_EQ(out[3].id, 3u);
+    ASSERT_EQ(queue.pop_n(out), 4u);
+    EXPECT_EQ(out[0].id, 4u);
+    ASSERT_EQ(queue.pop_n(out), 2u);
+    EXPECT_EQ(out[1].id, 9u);
+    EXPECT_EQ(queue.pop_n(out), 0u);
+}
+
+TEST(RuntimeTest, PostedEventsFromOtherThreadsAreDispatched) {
+    struct QuietBackend {
+        std::size_t poll_input(std::span<ege::Event>) { return 0; }
+        void present(const ege::CommandView&) {}
+    } backend;
+    ege::SPSCRenderPipeline<1024, 4, 8> pipeline;
+    ege::PhysicsSystem physics;
+    ege::RuntimeConfig config;
+    config.pacing.target_fps = 0.0;
+    ege::Runtime rt(backend, pipeline, physics, config);
+    DrawLayer layer;
+    rt.push_layer(&layer);
+
+    std::thread poster([&rt] {
+        ege::Event click{};
+        click.type = ege::EventType::Input;
+        click.id = 3;
+        click.payload.i = 1;
+        for (int i = 0; i < 5; ++i) EXPECT_TRUE(rt.post_event(click));
+        ege::Event quit{};
+        quit.type = ege::EventType::Input;
+        quit.id = uint32_t(ege::InputCode::Quit);
+        EXPECT_TRUE(rt.post_event(quit));
+    });
+    poster.join();
+    rt.run();
+    EXPECT_EQ(layer.clicks, 5);
+}
+
+TEST(RuntimeTest, ViewportSkipsOffscreenLayersAndTrimsGeometry) {
+    struct CountingLayer : DrawLayer {
+        int renders = 0;
+        void on_render(int frame_count) override { ++renders; DrawLayer::on_render(frame_count); }
+    };
+    FakeBackend backend;
+    ege::SPSCRenderPipeline<1024, 4, 8> pipeline;
+    ege::PhysicsSystem physics;
+    ege::RuntimeConfig config;
+    config.pacing.target_fps = 0.0;
+    ege::Runtime rt(backend, pipeline, physics, config);
+    rt.set_viewport({0, 0, 40, 64});
+
+    CountingLayer world, minimap, unbounded;
+    world.set_bounds({0, 0, 200, 200});
+    minimap.set_bounds({300, 0, 64, 64});
+    for (auto* l : {&world, &minimap, &unbounded}) {
+        l->show();
+        rt.push_layer(l);
+    }
+    rt.run();
+
+    EXPECT_GT(world.renders, 0);
+    EXPECT_EQ(minimap.renders, 0);
+    EXPECT_EQ(unbounded.renders, world.renders);
+    const auto& stats = rt.cull_stats();
+    EXPECT_EQ(stats.culled_layers, static_cast<uint64_t>(world.renders));
+    // The moving 20px rect crosses x = 40 after frame 20 and gets trimmed.
+    EXPECT_GT(stats.trimmed_commands, 0u);
+}
+
+TEST(RuntimeTest, CompactEncodingIsAppliedToEachBufferOnce) {
+    FakeBackend backend;
+    ege::SPSCRenderPipeline<1024, 4, 8> pipeline;
+    ege::PhysicsSystem physics;
+    ege::RuntimeConfig config;
+    config.pacing.target_fps = 0.0;
+    config.command_encoding = ege::CommandEncoding::Compact;
+    ege::Runtime rt(backend, pipeline, physics, config);
+    DrawLayer layer;
+    layer.show();
+    rt.push_layer(&layer);
+    rt.run();
+
+    // Every frame decodes to the clear and the rect.
+    EXPECT_EQ(backend.presented % 2, 0u);
+    EXPECT_GT(backend.presented, 0u);
+    pipeline.for_each_buffer([](std::size_t, const auto& buf) {
+        EXPECT_EQ(buf.encoding(), ege::CommandEncoding::Compact);
+    });
+}
+
+TEST(RuntimeTest, ThreadedMailboxPresentsWholeFramesUnderLoad) {
+    // The simulation thread records back to back while every present takes a
+    // while, so new frames land in the mailbox during presents.
+    struct SlowBackend {
+        std::atomic<int> polls{0};
+        std::atomic<int> presented{0};
+        std::atomic<int> torn{0};
+        std::size_t poll_input(std::span<ege::Event> out) {
+            if (polls.fetch_add(1) < 2000 || out.empty()) return 0;
+            out[0] = ege::Event{};
+            out[0].type = ege::EventType::Input;
+            out[0].id = uint32_t(ege::InputCode::Quit);
+            return 1;
+        }
+        void present(const ege::CommandView& view) {
+            uint32_t first = 0;
+            bool have = false;
+            view.for_each([&](const ege::RenderCommand& cmd) {
+                if (!have) { first = cmd.color; have = true; }
+                else if (cmd.color != first) torn.fetch_add(1);
+            });
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            presented.fetch_add(1);
+        }
+    } backend;
+    ege::MailboxRenderPipeline<1024> pipeline;
+    ege::PhysicsSystem physics;
+    ege::RuntimeConfig config;
+    config.pacing.target_fps = 0.0;
+    config.threading = ege::ThreadingMode::Threaded;
+    ege::Runtime rt(backend, pipeline, physics, config);
+    StampLayer layer;
+    layer.show();
+    rt.push_layer(&layer);
+    rt.run();
+
+    EXPECT_GT(backend.presented.load(), 0);
+    EXPECT_EQ(backend.torn.load(), 0);
+    EXPECT_GT(pipeline.overwritten_frames(), 0u);
+}
+
+TEST(RuntimeTest, ThreadedSpscPipelineReturnsEveryBuffer) {
+    // Frames are recorded back to back, so the render thread falls behind
+    // and the simulation thread regularly finds no free buffer.
+    ThreadedBackend backend;
+    backend.frames = 500;
+    ege::SPSCRenderPipeline<1024, 4, 8> pipeline;
+    ege::PhysicsSystem physics;
+    ege::RuntimeConfig config;
+    config.pacing.target_fps = 0.0;
+    config.threading = ege::ThreadingMode::Threaded;
+    ege::Runtime rt(backend, pipeline, physics, config);
+    StampLayer layer;
+    layer.show();
+    rt.push_layer(&layer);
+    rt.run();
+
+    EXPECT_GT(backend.presented.load(), 0);
+    EXPECT_EQ(backend.presented_on_sim_thread.load(), 0);
+    EXPECT_TRUE(all_buffers_free(pipeline, 4));
+}
+
+TEST(RuntimeTest, ThreadedQuitWhileRenderThreadSleepsShutsDownCleanly) {
+    // Each poll sleeps long enough for the render thread to present the
+    // previous frame and park, so the quit arrives while it is waiting.
+    ThreadedBackend backend;
+    backend.frames = 6;
+    backend.poll_delay = std::chrono::milliseconds(5);
+    ege::SPSCRenderPipeline<1024, 4, 8> pipeline;
+    ege::PhysicsSystem physics;
+    ege::RuntimeConfig config;
+    config.pacing.target_fps = 0.0;
+    config.threading = ege::ThreadingMode::Threaded;
+    ege::Runtime rt(backend, pipeline, physics, config);
+    StampLayer layer;
+    layer.show();
+    rt.push_layer(&layer);
+    rt.run();
+
+    // The frame recorded alongside the quit is still presented before the
+    // render thread exits, and nothing is left in flight.
+    EXPECT_EQ(backend.last_stamp.load(), backend.frames);
+    EXPECT_GE(backend.presented.load(), 1);
+    EXPECT_EQ(backend.presented_on_sim_thread.load(), 0);
+    EXPECT_TRUE(all_buffers_free(pipeline, 4));
+
+    // The runtime can run again after a clean shutdown.
+    backend.polls = 0;
+    rt.run();
+    EXPECT_EQ(backend.last_stamp.load(), backend.frames);
+    EXPECT_TRUE(all_buffers_free(pipeline, 4));
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <ege/engine/spsc_queue.hpp>
+
+TEST(SPSCQueueTest, IndicesLiveOnSeparateCacheLines) {
+    // head, tail and the buffer each start a cache line.
+    EXPECT_GE(sizeof(ege::SPSCQueue<uint32_t, 16>), 2 * ege::kCacheLineSize + 16 * sizeof(uint32_t));
+    EXPECT_EQ(alignof(ege::SPSCQueue<uint32_t, 16>), ege::kCacheLineSize);
+}
+
+TEST(SPSCQueueTest, BulkOperationsWrapAroundAndRespectCapacity) {
+    ege::SPSCQueue<int, 8> q; // 7 usable slots
+    std::array<int, 10> in{};
+    for (int i = 0; i < 10; ++i) in[static_cast<std::size_t>(i)] = i;
+    std::array<int, 10> out{};
+
+    EXPECT_EQ(q.push_n(std::span<const int>(in).first(5)), 5u);
+    EXPECT_EQ(q.pop_n(std::span<int>(out).first(4)), 4u); // tail = 4
+    // 6 more fit (7 usable, 1 still queued) and wrap past the end of the ring.
+    EXPECT_EQ(q.push_n(std::span<const int>(in).subspan(5)), 5u);
+    EXPECT_EQ(q.push_n(std::span<const int>(in).first(2)), 1u);
+    EXPECT_FALSE(q.push(99));
+
+    EXPECT_EQ(q.pop_n(out), 7u);
+    const std::array<int, 7> expected{4, 5, 6, 7, 8, 9, 0};
+    for (std::size_t i = 0; i < expected.size(); ++i) EXPECT_EQ(out[i], expected[i]) << i;
+    EXPECT_EQ(q.pop_n(out), 0u);
+    int v = 0;
+    EXPECT_FALSE(q.pop(v));
+}
+
+TEST(SPSCQueueTest, TwoThreadsMixedSingleAndBulkPreserveOrder) {
+    static ege::SPSCQueue<uint32_t, 64> q;
+    constexpr uint32_t kCount = 200000;
+    std::thread producer([] {
+        std::array<uint32_t, 5> batch{};
+        uint32_t next = 0;
+        while (next < kCount) {
+            if (next % 3 == 0) {
+                if (q.push(next)) ++next;
+                else std::this_thread::yield();
+                continue;
+            }
+            std::size_t n = 0;
+            for (; n < batch.size() && next + n < kCount; ++n) batch[n] = next + static_cast<uint32_t>(n);
+            const std::size_t pushed = q.push_n(std::span<const uint32_t>(batch).first(n));
+            if (pushed == 0) std::this_thread::yield();
+            next += static_cast<uint32_t>(pushed);
+        }
+    });
+    std::vector<uint32_t> received;
+    received.reserve(kCount);
+    std::array<uint32_t, 7> buf{};
+    while (received.size() < kCount) {
+        const std::size_t n = q.pop_n(buf);
+        if (n == 0) { std::this_thread::yield(); continue; }
+        received.insert(received.end(), buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+    producer.join();
+    for (uint32_t i = 0; i < kCount; ++i) ASSERT_EQ(received[i], i);
+}